@@ -1,12 +1,15 @@
 #include <QApplication>
 
 #include "mainwindow.h"
+#include "startup_timer.h"
 
 int main(int argc, char *argv[]) {
+    StartupTimer::start();
     QApplication app(argc, argv);
+    StartupTimer::mark("application created");
 
     MainWindow mainWin;
     mainWin.show();
 
     return app.exec();
-}
\ No newline at end of file
+}
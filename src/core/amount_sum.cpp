@@ -0,0 +1,77 @@
+#include "amount_sum.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GAMBLELIVE_HAVE_SSE2 1
+#endif
+
+namespace {
+
+// 1ブロックの件数と1件あたりの上限。2^52 未満が 1024 件なら合計は 2^62 未満で桁あふれしない
+constexpr size_t kBlockSize = 1024;
+constexpr int kSafeBits = 52;
+
+bool sumCheckedScalar(const qint64* values, size_t count, qint64& total)
+{
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i)
+        ok &= addAmount(total, values[i]);
+    return ok;
+}
+
+// ブロック内がすべて 0 以上 2^52 未満なら合計を返す。そうでなければ false
+bool sumBlock(const qint64* values, size_t count, qint64& blockSum)
+{
+    // 範囲を確かめるまでは符号なしで足す（符号付きの桁あふれは未定義動作）
+    quint64 bits = 0;
+    quint64 sum = 0;
+    size_t i = 0;
+
+#ifdef GAMBLELIVE_HAVE_SSE2
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    __m128i or0 = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 2));
+        acc0 = _mm_add_epi64(acc0, a);
+        acc1 = _mm_add_epi64(acc1, b);
+        or0 = _mm_or_si128(or0, _mm_or_si128(a, b));
+    }
+    alignas(16) quint64 lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(acc0, acc1));
+    sum = lanes[0] + lanes[1];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), or0);
+    bits = lanes[0] | lanes[1];
+#endif
+
+    for (; i < count; ++i) {
+        sum += static_cast<quint64>(values[i]);
+        bits |= static_cast<quint64>(values[i]);
+    }
+
+    // 負の値（最上位ビット）も上限超えとして弾く
+    if (bits >> kSafeBits) return false;
+    blockSum = static_cast<qint64>(sum);
+    return true;
+}
+
+} // namespace
+
+qint64 sumAmounts(const qint64* values, size_t count, bool* overflow)
+{
+    qint64 total = 0;
+    bool ok = true;
+
+    for (size_t first = 0; first < count; first += kBlockSize) {
+        const size_t n = count - first < kBlockSize ? count - first : kBlockSize;
+        qint64 blockSum;
+        if (sumBlock(values + first, n, blockSum))
+            ok &= addAmount(total, blockSum);
+        else
+            ok &= sumCheckedScalar(values + first, n, total);
+    }
+
+    if (overflow) *overflow = !ok;
+    return total;
+}
@@ -0,0 +1,24 @@
+#ifndef AMOUNT_SUM_H
+#define AMOUNT_SUM_H
+
+#include <QtNumeric>
+#include <cstddef>
+#include <limits>
+
+// 金額を1件加算する。桁あふれしたら上限（下限）で止めて false
+inline bool addAmount(qint64& total, qint64 amount)
+{
+    qint64 sum;
+    if (qAddOverflow(total, amount, &sum)) {
+        total = amount < 0 ? std::numeric_limits<qint64>::min() : std::numeric_limits<qint64>::max();
+        return false;
+    }
+    total = sum;
+    return true;
+}
+
+// 金額の列をまとめて合計する（SSE2 が使えればベクトル化）
+// 桁あふれしたら上限で止めて overflow に true を入れる
+qint64 sumAmounts(const qint64* values, size_t count, bool* overflow = nullptr);
+
+#endif // AMOUNT_SUM_H
@@ -0,0 +1,178 @@
+#include <QFile>
+#include <QtEndian>
+#include <zlib.h>
+
+#include "compressed_log.h"
+
+namespace {
+
+constexpr char kFileMagic[] = "GLZ2";
+constexpr char kStartMagic[] = "GLZS";
+constexpr char kContinueMagic[] = "GLZC";
+
+constexpr int kWindowBits = -15;      // ヘッダなしの deflate
+constexpr int kMemLevel = 8;
+constexpr int kOutputBlock = 16 * 1024;
+
+// 壊れたヘッダで巨大な確保をしないための上限（1チャンクは最大 1 ページ分）
+constexpr quint32 kMaxChunkBytes = 64 * 1024 * 1024;
+
+void appendU32(QByteArray& out, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, 4);
+}
+
+} // namespace
+
+QByteArray CompressedLog::fileHeader()
+{
+    return QByteArray(kFileMagic, 4);
+}
+
+QByteArray CompressedLog::encodeChunk(const Chunk& chunk)
+{
+    QByteArray out;
+    out.reserve(kChunkHeaderSize + chunk.data.size());
+    out.append(chunk.streamStart ? kStartMagic : kContinueMagic, 4);
+    appendU32(out, chunk.lineCount);
+    appendU32(out, static_cast<quint32>(chunk.data.size()));
+    out.append(chunk.data);
+    return out;
+}
+
+bool CompressedLog::readChunk(QIODevice& device, Chunk& chunk)
+{
+    const QByteArray header = device.read(kChunkHeaderSize);
+    if (header.size() != kChunkHeaderSize) return false;
+
+    if (header.startsWith(QByteArrayView(kStartMagic, 4)))
+        chunk.streamStart = true;
+    else if (header.startsWith(QByteArrayView(kContinueMagic, 4)))
+        chunk.streamStart = false;
+    else
+        return false;
+
+    chunk.lineCount = qFromLittleEndian<quint32>(header.constData() + 4);
+    const quint32 size = qFromLittleEndian<quint32>(header.constData() + 8);
+    if (size > kMaxChunkBytes) return false;
+
+    chunk.data = device.read(size);
+    return chunk.data.size() == static_cast<qsizetype>(size);  // 書きかけなら false
+}
+
+bool CompressedLog::isCompressed(QIODevice& device)
+{
+    return device.peek(kFileHeaderSize) == QByteArrayView(kFileMagic, 4);
+}
+
+bool CompressedLog::readAll(const QString& path, QByteArray& text)
+{
+    text.clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    if (!isCompressed(file)) {
+        text = file.readAll();
+        return true;
+    }
+
+    file.skip(kFileHeaderSize);
+    Inflater inflater;
+    Chunk chunk;
+    QByteArray part;
+    while (readChunk(file, chunk) && inflater.decompress(chunk, part))
+        text.append(part);
+    return true;
+}
+
+CompressedLog::Deflater::Deflater()
+    : stream_(std::make_unique<z_stream_s>())
+{
+}
+
+CompressedLog::Deflater::~Deflater()
+{
+    if (active_)
+        deflateEnd(stream_.get());
+}
+
+QByteArray CompressedLog::Deflater::compress(const QByteArray& text, bool finish)
+{
+    if (!active_) {
+        *stream_ = z_stream_s();
+        if (deflateInit2(stream_.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED, kWindowBits, kMemLevel,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+            return QByteArray();
+        active_ = true;
+    }
+
+    QByteArray out;
+    stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.constData()));
+    stream_->avail_in = static_cast<uInt>(text.size());
+
+    const int flush = finish ? Z_FINISH : Z_SYNC_FLUSH;
+    int status = Z_OK;
+    do {
+        const qsizetype used = out.size();
+        out.resize(used + kOutputBlock);
+        stream_->next_out = reinterpret_cast<Bytef*>(out.data() + used);
+        stream_->avail_out = kOutputBlock;
+        status = deflate(stream_.get(), flush);
+        out.resize(used + kOutputBlock - stream_->avail_out);
+    } while (stream_->avail_out == 0 || (finish && status == Z_OK));
+
+    if (finish) {
+        deflateEnd(stream_.get());
+        active_ = false;
+    }
+    return out;
+}
+
+CompressedLog::Inflater::Inflater()
+    : stream_(std::make_unique<z_stream_s>())
+{
+}
+
+CompressedLog::Inflater::~Inflater()
+{
+    if (active_)
+        inflateEnd(stream_.get());
+}
+
+bool CompressedLog::Inflater::decompress(const Chunk& chunk, QByteArray& text)
+{
+    text.clear();
+
+    if (chunk.streamStart) {
+        if (active_)
+            inflateEnd(stream_.get());
+        *stream_ = z_stream_s();
+        active_ = inflateInit2(stream_.get(), kWindowBits) == Z_OK;
+    }
+    if (!active_) return false;   // 続きのチャンクから読み始めた
+
+    stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.data.constData()));
+    stream_->avail_in = static_cast<uInt>(chunk.data.size());
+
+    int status = Z_OK;
+    do {
+        const qsizetype used = text.size();
+        text.resize(used + kOutputBlock);
+        stream_->next_out = reinterpret_cast<Bytef*>(text.data() + used);
+        stream_->avail_out = kOutputBlock;
+        status = inflate(stream_.get(), Z_SYNC_FLUSH);
+        text.resize(used + kOutputBlock - stream_->avail_out);
+        if (status == Z_STREAM_END) {
+            inflateEnd(stream_.get());
+            active_ = false;
+            return true;
+        }
+        if (status == Z_BUF_ERROR) break;                 // 入力を使い切った
+        if (status != Z_OK) return false;                 // 壊れている
+    } while (stream_->avail_in > 0 || stream_->avail_out == 0);
+
+    return true;
+}
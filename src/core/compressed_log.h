@@ -0,0 +1,71 @@
+#ifndef COMPRESSED_LOG_H
+#define COMPRESSED_LOG_H
+
+#include <QByteArray>
+#include <QString>
+#include <memory>
+
+class QIODevice;
+struct z_stream_s;
+
+// 圧縮したセッションログの形式
+//   ファイル先頭: "GLZ2"
+//   チャンク    : "GLZS"（ストリーム開始）または "GLZC"（続き）, 行数, バイト数（いずれも u32 LE）+ deflate の出力
+// ページ（SessionLogFile::kPageLines 行）ごとに1本の deflate ストリームを使い、チェックポイントでは
+// Z_SYNC_FLUSH で区切ってチャンクとして書く。辞書はページ内で引き継ぐので短い区切りでも圧縮率は落ちない
+// チャンクは1回の write で書くので、途中で落ちても失うのは最後のチェックポイント以降の行だけ
+namespace CompressedLog {
+
+constexpr qint64 kFileHeaderSize = 4;
+constexpr qint64 kChunkHeaderSize = 12;
+
+QByteArray fileHeader();
+
+struct Chunk {
+    bool streamStart = false;
+    quint32 lineCount = 0;
+    QByteArray data;     // deflate の出力
+};
+
+QByteArray encodeChunk(const Chunk& chunk);
+
+// 現在位置から1チャンク読む。末尾・書きかけ・壊れたチャンクなら false
+bool readChunk(QIODevice& device, Chunk& chunk);
+
+// 先頭が圧縮形式か（読み取り位置は変えない）
+bool isCompressed(QIODevice& device);
+
+// 圧縮・非圧縮どちらのファイルも全体をテキストとして読む
+bool readAll(const QString& path, QByteArray& text);
+
+// ページ1本分の deflate ストリーム
+class Deflater {
+public:
+    Deflater();
+    ~Deflater();
+
+    bool isActive() const { return active_; }
+    // text を圧縮して出力を返す。finish ならストリームを閉じ、そうでなければ Z_SYNC_FLUSH で区切る
+    QByteArray compress(const QByteArray& text, bool finish);
+
+private:
+    std::unique_ptr<z_stream_s> stream_;
+    bool active_ = false;
+};
+
+// チャンクの並びを展開する（ストリーム開始のチャンクで作り直す）
+class Inflater {
+public:
+    Inflater();
+    ~Inflater();
+
+    bool decompress(const Chunk& chunk, QByteArray& text);
+
+private:
+    std::unique_ptr<z_stream_s> stream_;
+    bool active_ = false;
+};
+
+} // namespace CompressedLog
+
+#endif // COMPRESSED_LOG_H
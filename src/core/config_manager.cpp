@@ -1,9 +1,14 @@
 #include <QCoreApplication>
+#include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QFileSystemWatcher>
 #include <QJsonDocument>
+#include <QTimer>
+#include <atomic>
 
 #include "config_manager.h"
+#include "startup_timer.h"
 
 ConfigManager::ConfigManager()
 {
@@ -16,10 +21,38 @@ ConfigManager::ConfigManager()
         {"SlotName", "None"},
         {"LogDirectory", ""},
         {"EnableLogSave", true},
+        {"EnableLogCompression", false},
         {"Encoding", "Shift-JIS"},
         {"LogUpdateInterval", 100},
+        {"OverlayServerEnabled", false},
+        {"OverlayServerPort", 18080},
+        {"ParseRules", QJsonArray{
+            QJsonObject{
+                {"name", "Man10Slot"},
+                {"rules", QJsonArray{
+                    QJsonObject{{"type", "Payment"}, {"pattern", "{amount}円支払いました"}},
+                    QJsonObject{{"type", "Gain"}, {"pattern", "{amount}円受け取りました"}},
+                    QJsonObject{{"type", "Lose"}, {"pattern", "[Man10Slot]外れました"}},
+                    QJsonObject{{"type", "Role"}, {"pattern", "[Man10Slot]おめでとうございます！{role}です！"}},
+                }},
+            },
+        }},
     };
     load();  // 起動時にロード
+    StartupTimer::mark("config loaded");
+
+    // config.json を監視してホットリロード
+    fileWatcher_ = new QFileSystemWatcher(this);
+    if (QFile::exists(path_))
+        fileWatcher_->addPath(path_);
+    connect(fileWatcher_, &QFileSystemWatcher::fileChanged, this, &ConfigManager::onFileChanged);
+    if (QCoreApplication::instance()) {
+        // 静的オブジェクトの破棄はアプリ終了後になるため、監視だけ先に止める
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            delete fileWatcher_;
+            fileWatcher_ = nullptr;
+        });
+    }
 }
 
 ConfigManager& ConfigManager::instance()
@@ -33,7 +66,8 @@ void ConfigManager::load()
     QFile file(path_);
     if (!file.open(QIODevice::ReadOnly)) {
         config_ = default_config_;
-        save();
+        saveLater();
+        publish();
         return;
     }
 
@@ -42,7 +76,8 @@ void ConfigManager::load()
     QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
     if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
         config_ = default_config_;
-        save();
+        saveLater();
+        publish();
         return;
     }
 
@@ -58,14 +93,17 @@ void ConfigManager::load()
     }
 
     if (modified) {
-        save();  // 補完があった場合は保存
+        saveLater();  // 補完があった場合は保存
     }
 
     file.close();
+    publish();
 }
 
 void ConfigManager::save()
 {
+    savePending_ = false;  // 予約済みの保存もこれで済む
+
     QJsonDocument doc(config_);
     QFile file(path_);
 
@@ -79,6 +117,26 @@ void ConfigManager::save()
     if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return;
     file.write(doc.toJson(QJsonDocument::Indented));
     file.close();
+
+    // 初回作成時は監視対象に追加
+    if (fileWatcher_ && !fileWatcher_->files().contains(path_))
+        fileWatcher_->addPath(path_);
+}
+
+void ConfigManager::saveLater()
+{
+    if (!QCoreApplication::instance()) {
+        save();
+        return;
+    }
+    if (savePending_) return;
+
+    savePending_ = true;
+    QTimer::singleShot(0, this, [this]() {
+        if (!savePending_) return;
+        savePending_ = false;
+        save();
+    });
 }
 
 QVariant ConfigManager::get(const QString &key) const
@@ -91,9 +149,72 @@ void ConfigManager::set(const QString &key, const QVariant &value)
 {
     if(!config_.contains(key)) return;
     config_[key] = QJsonValue::fromVariant(value);
+    publish();
 }
 
 const QJsonObject& ConfigManager::defaultConfig() const
 {
     return default_config_;
 }
+
+std::shared_ptr<const ConfigSnapshot> ConfigManager::snapshot() const
+{
+    return std::atomic_load(&snapshot_);
+}
+
+void ConfigManager::publish()
+{
+    auto next = std::make_shared<ConfigSnapshot>();
+    next->filePath = config_.value("FilePath").toString();
+    next->chatPrefix = config_.value("ChatPrefix").toString();
+    next->slotName = config_.value("SlotName").toString();
+    next->logDirectory = config_.value("LogDirectory").toString();
+    next->enableLogSave = config_.value("EnableLogSave").toBool(true);
+    next->enableLogCompression = config_.value("EnableLogCompression").toBool(false);
+    next->encoding = config_.value("Encoding").toString();
+    next->logUpdateInterval = qMax(1, config_.value("LogUpdateInterval").toInt(100));
+    next->overlayServerEnabled = config_.value("OverlayServerEnabled").toBool(false);
+    next->overlayServerPort = config_.value("OverlayServerPort").toInt(18080);
+    if (next->overlayServerEnabled && !next->isOverlayServerPortValid())
+        qWarning() << "OverlayServerPort が範囲外です（1〜65535）:" << next->overlayServerPort;
+
+    const QJsonArray ruleSets = config_.value("ParseRules").toArray();
+    for (const QJsonValue& setValue : ruleSets) {
+        const QJsonObject ruleSet = setValue.toObject();
+        const QString setName = ruleSet.value("name").toString();
+        for (const QJsonValue& ruleValue : ruleSet.value("rules").toArray()) {
+            const QJsonObject rule = ruleValue.toObject();
+            next->parseRules.append({ setName, rule.value("type").toString(), rule.value("pattern").toString() });
+        }
+    }
+
+    std::atomic_store(&snapshot_, std::shared_ptr<const ConfigSnapshot>(std::move(next)));
+    emit snapshotChanged();
+}
+
+void ConfigManager::onFileChanged(const QString &path)
+{
+    // エディタによっては削除→再作成で保存されるため監視を張り直す
+    if (fileWatcher_ && QFile::exists(path) && !fileWatcher_->files().contains(path))
+        fileWatcher_->addPath(path);
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    // 書き込み途中などで壊れている場合は現在の設定を維持
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) return;
+
+    QJsonObject loaded = doc.object();
+    for (auto it = default_config_.begin(); it != default_config_.end(); ++it) {
+        if (!loaded.contains(it.key()))
+            loaded[it.key()] = it.value();
+    }
+
+    // 自分の save() による変更通知は無視
+    if (loaded == config_) return;
+
+    config_ = loaded;
+    publish();
+}
@@ -5,23 +5,63 @@
 #include <QJsonArray>
 #include <QObject>
 #include <QString>
+#include <memory>
+
+#include "parse_rule_config.h"
+
+class QFileSystemWatcher;
+
+// 型付き設定スナップショット（不変）。公開後は変更されないのでロックなしで読める
+struct ConfigSnapshot {
+    QString filePath;
+    QString chatPrefix;
+    QString slotName;
+    QString logDirectory;
+    bool enableLogSave = true;
+    bool enableLogCompression = false;   // セッションログを .logz（圧縮フレーム）で保存
+    QString encoding;
+    int logUpdateInterval = 100;
+    QList<ParseRuleConfig> parseRules;
+    bool overlayServerEnabled = false;
+    int overlayServerPort = 18080;       // 設定ファイルの値そのまま（範囲外でも丸めない）
+
+    bool isOverlayServerPortValid() const { return overlayServerPort >= 1 && overlayServerPort <= 65535; }
+};
+
+class ConfigManager : public QObject {
+    Q_OBJECT
 
-class ConfigManager {
 public:
     static ConfigManager& instance();
 
     void load();                  // ファイルから読み込み
     void save();                  // ファイルへ保存
+    void saveLater();             // イベントループに戻ってから保存（起動を待たせない）
     QVariant get(const QString &key) const;
     void set(const QString &key, const QVariant &value);
     const QJsonObject& defaultConfig() const;
 
+    // 現在のスナップショットを取得（任意のスレッドからロックなしで呼べる）
+    std::shared_ptr<const ConfigSnapshot> snapshot() const;
+
+signals:
+    void snapshotChanged();
+
+private slots:
+    void onFileChanged(const QString &path);
+
 private:
     ConfigManager();           
+    void publish();               // config_ からスナップショットを作り直して公開
+
     QJsonObject config_;
     QJsonObject default_config_;
     QString path_;
 
+    std::shared_ptr<const ConfigSnapshot> snapshot_;
+    QFileSystemWatcher *fileWatcher_ = nullptr;
+    bool savePending_ = false;
+
     ConfigManager(const ConfigManager&) = delete;
     ConfigManager& operator=(const ConfigManager&) = delete;
 };
@@ -0,0 +1,131 @@
+#include <algorithm>
+
+#include "amount_sum.h"
+#include "event_index.h"
+
+namespace {
+
+constexpr qint64 kSecondsPerDay = 24 * 60 * 60;
+
+} // namespace
+
+quint32 EventIndex::append(GambleLogType type, qint32 secondsOfDay, qint64 amount, quint32 roleId)
+{
+    const quint32 row = size();
+
+    // 時刻が半日以上戻ったら日付が変わったとみなす
+    qint64 time = times_.empty() ? 0 : times_.back();
+    if (secondsOfDay != kNoLogTime) {
+        if (lastSecondsOfDay_ != kNoLogTime && secondsOfDay + kSecondsPerDay / 2 < lastSecondsOfDay_)
+            dayOffset_ += kSecondsPerDay;
+        time = qMax(time, dayOffset_ + secondsOfDay);
+        lastSecondsOfDay_ = secondsOfDay;
+    }
+
+    types_.push_back(static_cast<quint8>(type));
+    secondsOfDay_.push_back(secondsOfDay);
+    times_.push_back(time);
+    amounts_.push_back(amount);
+    roleIds_.push_back(roleId);
+
+    byType_[static_cast<int>(type)].push_back(row);
+    amountsByType_[static_cast<int>(type)].push_back(amount);
+    if (roleId != kNoRole)
+        byRole_[roleId].push_back(row);
+
+    return row;
+}
+
+bool EventIndex::matches(quint32 row, const EventQuery& query, const TextLookup& text) const
+{
+    if (query.type >= 0 && types_[row] != query.type) return false;
+    if (query.roleId != kNoRole && roleIds_[row] != query.roleId) return false;
+    if (amounts_[row] < query.minAmount || amounts_[row] > query.maxAmount) return false;
+    const qint64 from = fromTime(query);
+    if (from >= 0 && times_[row] < from) return false;
+    if (query.toTime >= 0 && times_[row] > query.toTime) return false;
+    if (!query.text.isEmpty() && (!text || !text(row).contains(query.text, Qt::CaseInsensitive))) return false;
+    return true;
+}
+
+std::vector<quint32> EventIndex::search(const EventQuery& query, size_t limit, const TextLookup& text) const
+{
+    std::vector<quint32> result;
+    if (types_.empty() || limit == 0) return result;
+
+    // 時刻条件を行番号の範囲に変換
+    quint32 first = 0;
+    quint32 last = size();
+    const qint64 from = fromTime(query);
+    if (from >= 0)
+        first = firstRowAt(from);
+    if (query.toTime >= 0)
+        last = static_cast<quint32>(std::upper_bound(times_.begin(), times_.end(), query.toTime) - times_.begin());
+    if (first >= last) return result;
+
+    // 最も短い行リストを候補にする（なければ範囲全体を走査）
+    const std::vector<quint32>* candidates = nullptr;
+    auto consider = [&](const std::vector<quint32>* rows) {
+        if (!candidates || rows->size() < candidates->size())
+            candidates = rows;
+    };
+
+    static const std::vector<quint32> kEmpty;
+    if (query.type >= 0 && query.type < 4)
+        consider(&byType_[query.type]);
+    if (query.roleId != kNoRole) {
+        auto it = byRole_.constFind(query.roleId);
+        consider(it != byRole_.cend() ? &it.value() : &kEmpty);
+    }
+    if (!query.text.isEmpty() && !text)
+        return result;
+
+    if (candidates) {
+        // 新しい方から調べて limit 件で打ち切る
+        auto begin = std::lower_bound(candidates->begin(), candidates->end(), first);
+        auto end = std::lower_bound(candidates->begin(), candidates->end(), last);
+        for (auto it = end; it != begin && result.size() < limit; ) {
+            --it;
+            if (matches(*it, query, text))
+                result.push_back(*it);
+        }
+    } else {
+        for (quint32 row = last; row > first && result.size() < limit; ) {
+            --row;
+            if (matches(row, query, text))
+                result.push_back(row);
+        }
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+quint32 EventIndex::firstRowAt(qint64 time) const
+{
+    return static_cast<quint32>(std::lower_bound(times_.begin(), times_.end(), time) - times_.begin());
+}
+
+qint64 EventIndex::fromTime(const EventQuery& query) const
+{
+    if (query.recentSeconds < 0) return query.fromTime;
+    return qMax(query.fromTime, qMax<qint64>(0, latestTime() - query.recentSeconds));
+}
+
+qint64 EventIndex::sumAmount(GambleLogType type, quint32 firstRow, quint32 lastRow, quint32* count) const
+{
+    const std::vector<quint32>& rows = byType_[static_cast<int>(type)];
+    const auto begin = std::lower_bound(rows.begin(), rows.end(), firstRow);
+    const auto end = std::lower_bound(begin, rows.end(), lastRow);
+
+    // 行リストと金額の列は同じ並びなので、範囲をそのまま合計する
+    const size_t offset = static_cast<size_t>(begin - rows.begin());
+    const size_t n = static_cast<size_t>(end - begin);
+    if (count) *count = static_cast<quint32>(n);
+    return sumAmounts(amountsByType_[static_cast<int>(type)].data() + offset, n);
+}
+
+void EventIndex::clear()
+{
+    *this = EventIndex();
+}
@@ -0,0 +1,80 @@
+#ifndef EVENT_INDEX_H
+#define EVENT_INDEX_H
+
+#include <QHash>
+#include <QString>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "log_parser.h"
+
+// 検索条件。未指定の項目は条件にしない
+struct EventQuery {
+    int type = -1;                                          // GambleLogType の値
+    quint32 roleId = kNoRole;
+    qint64 minAmount = std::numeric_limits<qint64>::min();
+    qint64 maxAmount = std::numeric_limits<qint64>::max();
+    qint64 fromTime = -1;                                   // セッション内秒数
+    qint64 toTime = -1;
+    qint64 recentSeconds = -1;                              // 最新の行から遡る秒数（行が増えるたびに窓が進む）
+    QString text;                                           // 本文の部分一致
+
+    bool isEmpty() const {
+        return type < 0 && roleId == kNoRole
+            && minAmount == std::numeric_limits<qint64>::min()
+            && maxAmount == std::numeric_limits<qint64>::max()
+            && fromTime < 0 && toTime < 0 && recentSeconds < 0 && text.isEmpty();
+    }
+};
+
+// セッション中のイベントの索引。追加のたびに更新し、作り直しはしない
+//   種別・役ごとの行リストと数値の列だけを持ち、本文は持たない（1行あたり数十バイト）
+//   本文の条件は呼び出し側が渡す TextLookup（セッションログのファイル）で確かめる
+//   時刻は単調増加なので範囲検索は二分探索
+class EventIndex {
+public:
+    // 行番号 → 本文
+    using TextLookup = std::function<QString(quint32 row)>;
+
+    // roleId は当たり役の行なら役、受け取りの行なら対応する回転の役
+    quint32 append(GambleLogType type, qint32 secondsOfDay, qint64 amount, quint32 roleId);
+
+    // 条件に一致する行番号を古い順に返す（新しい方から最大 limit 件）
+    // 本文の条件は text がなければ一致しない
+    std::vector<quint32> search(const EventQuery& query, size_t limit, const TextLookup& text = {}) const;
+    bool matches(quint32 row, const EventQuery& query, const TextLookup& text = {}) const;
+
+    quint32 size() const { return static_cast<quint32>(types_.size()); }
+    GambleLogType type(quint32 row) const { return static_cast<GambleLogType>(types_[row]); }
+    qint64 amount(quint32 row) const { return amounts_[row]; }
+    quint32 roleId(quint32 row) const { return roleIds_[row]; }
+    qint64 time(quint32 row) const { return times_[row]; }
+    qint32 secondsOfDay(quint32 row) const { return secondsOfDay_[row]; }
+    qint64 latestTime() const { return times_.empty() ? 0 : times_.back(); }
+
+    // 時刻が time 以上の最初の行
+    quint32 firstRowAt(qint64 time) const;
+    // fromTime と recentSeconds を合わせた、いまの時刻の下限（条件なしは -1）
+    qint64 fromTime(const EventQuery& query) const;
+    // [firstRow, lastRow) にある type の行の金額の合計（count には件数）
+    qint64 sumAmount(GambleLogType type, quint32 firstRow, quint32 lastRow, quint32* count = nullptr) const;
+
+    void clear();
+
+private:
+    std::vector<quint8> types_;
+    std::vector<qint32> secondsOfDay_;
+    std::vector<qint64> times_;         // セッション内秒数（日付またぎ補正済み）
+    std::vector<qint64> amounts_;
+    std::vector<quint32> roleIds_;
+
+    std::vector<quint32> byType_[4];
+    std::vector<qint64> amountsByType_[4];   // byType_ と同じ並びの金額（集計用）
+    QHash<quint32, std::vector<quint32>> byRole_;
+
+    qint64 dayOffset_ = 0;
+    qint32 lastSecondsOfDay_ = kNoLogTime;
+};
+
+#endif // EVENT_INDEX_H
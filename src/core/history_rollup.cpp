@@ -0,0 +1,334 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include "amount_sum.h"
+#include "compressed_log.h"
+#include "event_index.h"
+#include "history_rollup.h"
+#include "log_parser.h"
+
+namespace {
+
+constexpr qint64 kSecondsPerDay = 24 * 60 * 60;
+constexpr int kFileVersion = 1;
+
+QJsonObject bucketToJson(qint64 start, const RollupBucket& bucket)
+{
+    QJsonObject roles;
+    for (auto it = bucket.roleCount.cbegin(); it != bucket.roleCount.cend(); ++it)
+        roles[it.key()] = it.value();
+
+    return QJsonObject{
+        {"t", start},
+        {"s", bucket.spent},
+        {"g", bucket.gained},
+        {"n", bucket.spins},
+        {"r", roles},
+    };
+}
+
+RollupBucket bucketFromJson(const QJsonObject& json)
+{
+    RollupBucket bucket;
+    bucket.spent = json.value("s").toInteger();
+    bucket.gained = json.value("g").toInteger();
+    bucket.spins = json.value("n").toInt();
+    const QJsonObject roles = json.value("r").toObject();
+    for (auto it = roles.begin(); it != roles.end(); ++it)
+        bucket.roleCount.insert(it.key(), it.value().toInt());
+    return bucket;
+}
+
+} // namespace
+
+void RollupBucket::add(const RollupBucket& other)
+{
+    addAmount(spent, other.spent);
+    addAmount(gained, other.gained);
+    spins += other.spins;
+    for (auto it = other.roleCount.cbegin(); it != other.roleCount.cend(); ++it)
+        roleCount[it.key()] += it.value();
+}
+
+std::map<qint64, RollupBucket>& HistoryRollup::SlotBuckets::of(RollupGranularity granularity)
+{
+    switch (granularity) {
+    case RollupGranularity::Hour: return hourly;
+    case RollupGranularity::Day: return daily;
+    case RollupGranularity::Month: break;
+    }
+    return monthly;
+}
+
+const std::map<qint64, RollupBucket>& HistoryRollup::SlotBuckets::of(RollupGranularity granularity) const
+{
+    return const_cast<SlotBuckets*>(this)->of(granularity);
+}
+
+HistoryRollup::HistoryRollup(const QString& logDir)
+    : logDir_(logDir)
+    , path_(QDir(logDir).filePath("history_rollup.json"))
+{
+}
+
+qint64 HistoryRollup::bucketStart(qint64 epochSeconds, RollupGranularity granularity)
+{
+    const QDateTime time = QDateTime::fromSecsSinceEpoch(epochSeconds);
+    switch (granularity) {
+    case RollupGranularity::Hour:
+        return QDateTime(time.date(), QTime(time.time().hour(), 0)).toSecsSinceEpoch();
+    case RollupGranularity::Day:
+        return QDateTime(time.date(), QTime(0, 0)).toSecsSinceEpoch();
+    case RollupGranularity::Month:
+        break;
+    }
+    return QDateTime(QDate(time.date().year(), time.date().month(), 1), QTime(0, 0)).toSecsSinceEpoch();
+}
+
+bool HistoryRollup::load()
+{
+    slots_.clear();
+    sessions_.clear();
+
+    QFile file(path_);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) return false;
+
+    const QJsonObject root = doc.object();
+    if (root.value("version").toInt() != kFileVersion) return false;
+
+    for (const QJsonValue& session : root.value("sessions").toArray())
+        sessions_.insert(session.toString());
+
+    // 保存するのは時間単位だけ。日・月単位は読み込み時に作る
+    const QJsonObject slotsJson = root.value("slots").toObject();
+    for (auto it = slotsJson.begin(); it != slotsJson.end(); ++it) {
+        SlotBuckets& slot = slots_[it.key()];
+        for (const QJsonValue& value : it.value().toArray()) {
+            const QJsonObject json = value.toObject();
+            const qint64 start = json.value("t").toInteger();
+            const RollupBucket bucket = bucketFromJson(json);
+            slot.hourly[start].add(bucket);
+            slot.daily[bucketStart(start, RollupGranularity::Day)].add(bucket);
+            slot.monthly[bucketStart(start, RollupGranularity::Month)].add(bucket);
+        }
+    }
+    return true;
+}
+
+bool HistoryRollup::save() const
+{
+    QJsonObject slotsJson;
+    for (auto it = slots_.cbegin(); it != slots_.cend(); ++it) {
+        QJsonArray hourly;
+        for (const auto& [start, bucket] : it.value().hourly)
+            hourly.append(bucketToJson(start, bucket));
+        slotsJson[it.key()] = hourly;
+    }
+
+    QJsonArray sessions;
+    for (const QString& session : sessions_)
+        sessions.append(session);
+
+    const QJsonObject root{
+        {"version", kFileVersion},
+        {"sessions", sessions},
+        {"slots", slotsJson},
+    };
+
+    // 書き込み途中で落ちても前回の内容が残るように一時ファイルから置き換える
+    QSaveFile file(path_);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    const QByteArray data = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void HistoryRollup::addSession(const QString& slotName, const QString& sessionKey,
+                               const std::map<qint64, RollupBucket>& hourly)
+{
+    if (sessions_.contains(sessionKey)) return;
+    sessions_.insert(sessionKey);
+
+    SlotBuckets& slot = slots_[slotName];
+    for (const auto& [start, bucket] : hourly) {
+        slot.hourly[start].add(bucket);
+        slot.daily[bucketStart(start, RollupGranularity::Day)].add(bucket);
+        slot.monthly[bucketStart(start, RollupGranularity::Month)].add(bucket);
+    }
+}
+
+int HistoryRollup::importInfoFiles()
+{
+    QDir dir(logDir_);
+    const QStringList fileList = dir.entryList({ "*_info_*.log" }, QDir::Files, QDir::Name);
+
+    QStringList pending;
+    for (const QString& fileName : fileList) {
+        if (!sessions_.contains(QFileInfo(fileName).completeBaseName()))
+            pending << fileName;
+    }
+    if (pending.isEmpty()) return 0;
+
+    // ファイルの読み込みと解析は並列に行い、集計への追加だけを順番に行う
+    struct ImportedInfo {
+        QString sessionKey;
+        QString slotName;
+        QDateTime start;
+        RollupBucket bucket;
+        bool valid = false;
+    };
+    const QList<ImportedInfo> parsed = QtConcurrent::blockingMapped(pending, [&dir](const QString& fileName) {
+        ImportedInfo info;
+        info.sessionKey = QFileInfo(fileName).completeBaseName();
+        info.valid = parseInfoFileName(fileName, info.slotName, info.start)
+                  && parseInfoFile(dir.filePath(fileName), info.bucket);
+        return info;
+    });
+
+    int imported = 0;
+    for (const ImportedInfo& info : parsed) {
+        if (!info.valid) continue;
+
+        std::map<qint64, RollupBucket> hourly;
+        hourly[bucketStart(info.start.toSecsSinceEpoch(), RollupGranularity::Hour)] = info.bucket;
+        addSession(info.slotName, info.sessionKey, hourly);
+        ++imported;
+    }
+    return imported;
+}
+
+std::vector<std::pair<qint64, RollupBucket>> HistoryRollup::buckets(const QString& slotName, RollupGranularity granularity,
+                                                                    const QDateTime& from, const QDateTime& to) const
+{
+    std::vector<std::pair<qint64, RollupBucket>> result;
+
+    auto slot = slots_.constFind(slotName);
+    if (slot == slots_.cend()) return result;
+
+    const auto& map = slot->of(granularity);
+    auto it = map.lower_bound(from.toSecsSinceEpoch());
+    const auto end = map.lower_bound(to.toSecsSinceEpoch());
+    for (; it != end; ++it)
+        result.emplace_back(it->first, it->second);
+    return result;
+}
+
+RollupBucket HistoryRollup::total(const QString& slotName, RollupGranularity granularity,
+                                  const QDateTime& from, const QDateTime& to) const
+{
+    RollupBucket result;
+
+    auto slot = slots_.constFind(slotName);
+    if (slot == slots_.cend()) return result;
+
+    const auto& map = slot->of(granularity);
+    auto it = map.lower_bound(from.toSecsSinceEpoch());
+    const auto end = map.lower_bound(to.toSecsSinceEpoch());
+    for (; it != end; ++it)
+        result.add(it->second);
+    return result;
+}
+
+std::map<qint64, RollupBucket> HistoryRollup::hourlyFromIndex(const EventIndex& index, const RoleTable& roles,
+                                                              const QDateTime& start)
+{
+    std::map<qint64, RollupBucket> hourly;
+
+    // 索引の時刻は最初のイベントの日の 0 時からの秒数
+    const qint64 startEpoch = start.toSecsSinceEpoch();
+    qint64 base = QDateTime(start.date(), QTime(0, 0)).toSecsSinceEpoch();
+    for (quint32 row = 0; row < index.size(); ++row) {
+        const qint32 seconds = index.secondsOfDay(row);
+        if (seconds == kNoLogTime) continue;
+        // 開始直後に日付が変わった場合
+        if (seconds + kSecondsPerDay / 2 < start.time().msecsSinceStartOfDay() / 1000)
+            base += kSecondsPerDay;
+        break;
+    }
+
+    // 時刻は単調増加なので1時間分は連続した行になる。金額は種別ごとの列をまとめて合計する
+    quint32 first = 0;
+    while (first < index.size()) {
+        const qint64 hour = bucketStart(qMax(startEpoch, base + index.time(first)), RollupGranularity::Hour);
+        const quint32 last = qMax(first + 1, index.firstRowAt(hour + 60 * 60 - base));
+        RollupBucket& bucket = hourly[hour];
+
+        quint32 spins = 0;
+        addAmount(bucket.spent, index.sumAmount(GambleLogType::Payment, first, last, &spins));
+        addAmount(bucket.gained, index.sumAmount(GambleLogType::Gain, first, last));
+        bucket.spins += static_cast<int>(spins);
+
+        for (quint32 row = first; row < last; ++row) {
+            if (index.type(row) == GambleLogType::Role && index.roleId(row) != kNoRole)
+                bucket.roleCount[roles.name(index.roleId(row))]++;
+        }
+        first = last;
+    }
+    return hourly;
+}
+
+bool HistoryRollup::parseInfoFile(const QString& path, RollupBucket& bucket)
+{
+    // 圧縮して保存されたファイルも読めるようにまとめて読む
+    QByteArray data;
+    if (!CompressedLog::readAll(path, data)) return false;
+
+    // 取り込み時は複数スレッドから呼ばれる（static の正規表現は読み取りのみ）
+    static const QRegularExpression numberExp(R"((\d+))");
+    static const QRegularExpression roleExp(R"(^(.+?):\s*(\d+)回)");
+
+    // 64bit に収まらない数値はファイルが壊れているとみなす
+    bool valid = true;
+    auto extractNumber = [&valid](const QString& line) -> qint64 {
+        QRegularExpressionMatch m = numberExp.match(line);
+        if (!m.hasMatch()) return 0;
+        bool ok = false;
+        const qint64 value = m.captured(1).toLongLong(&ok);
+        valid &= ok;
+        return value;
+    };
+
+    QTextStream in(data);
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+
+        if (line.startsWith("支出:")) {
+            addAmount(bucket.spent, extractNumber(line));
+        } else if (line.startsWith("収入:")) {
+            addAmount(bucket.gained, extractNumber(line));
+        } else if (line.startsWith("回転数:")) {
+            bucket.spins += static_cast<int>(extractNumber(line));
+        } else if (line.contains(":") && line.contains("回")) {
+            QRegularExpressionMatch m = roleExp.match(line);
+            if (m.hasMatch())
+                bucket.roleCount[m.captured(1).trimmed()] += m.captured(2).toInt();
+        }
+    }
+    return valid;
+}
+
+bool HistoryRollup::parseInfoFileName(const QString& fileName, QString& slotName, QDateTime& start)
+{
+    static const QRegularExpression nameExp(R"(^(.*)_info_(\d{8}_\d{6})\.log$)");
+    QRegularExpressionMatch m = nameExp.match(fileName);
+    if (!m.hasMatch()) return false;
+
+    slotName = m.captured(1);
+    start = QDateTime::fromString(m.captured(2), "yyyyMMdd_HHmmss");
+    return start.isValid();
+}
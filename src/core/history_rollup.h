@@ -0,0 +1,86 @@
+#ifndef HISTORY_ROLLUP_H
+#define HISTORY_ROLLUP_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <map>
+#include <vector>
+
+class EventIndex;
+class RoleTable;
+
+// 集計の単位期間
+enum class RollupGranularity {
+    Hour,
+    Day,
+    Month
+};
+
+// 1期間分の集計
+struct RollupBucket {
+    qint64 spent = 0;
+    qint64 gained = 0;
+    int spins = 0;
+    QMap<QString, int> roleCount;
+
+    void add(const RollupBucket& other);
+};
+
+// スロットごとの時間・日・月単位の集計（記録先フォルダの history_rollup.json に保存）
+// セッション終了時に追加するだけで、期間指定の集計は範囲内の期間数に比例するコストで済む
+class HistoryRollup {
+public:
+    explicit HistoryRollup(const QString& logDir);
+
+    bool load();
+    bool save() const;
+
+    // 記録先フォルダの _info_ ファイルのうち未登録のものを取り込む（開始時刻の1時間に計上）
+    int importInfoFiles();
+
+    // セッションを追加する。sessionKey は _info_ ファイル名（拡張子なし）と同じ形式
+    void addSession(const QString& slotName, const QString& sessionKey,
+                    const std::map<qint64, RollupBucket>& hourly);
+    bool hasSession(const QString& sessionKey) const { return sessions_.contains(sessionKey); }
+
+    // [from, to) の期間ごとの集計
+    std::vector<std::pair<qint64, RollupBucket>> buckets(const QString& slotName, RollupGranularity granularity,
+                                                         const QDateTime& from, const QDateTime& to) const;
+    // [from, to) の合計
+    RollupBucket total(const QString& slotName, RollupGranularity granularity,
+                       const QDateTime& from, const QDateTime& to) const;
+
+    QStringList slotNames() const { return slots_.keys(); }
+    QString logDir() const { return logDir_; }
+    QString path() const { return path_; }
+
+    // セッション中のイベントを1時間ごとにまとめる（start はセッション開始時刻）
+    static std::map<qint64, RollupBucket> hourlyFromIndex(const EventIndex& index, const RoleTable& roles,
+                                                          const QDateTime& start);
+    // _info_ ファイル（統計情報）を読む
+    static bool parseInfoFile(const QString& path, RollupBucket& bucket);
+    // "<スロット名>_info_<yyyyMMdd_HHmmss>.log" を分解
+    static bool parseInfoFileName(const QString& fileName, QString& slotName, QDateTime& start);
+
+    static qint64 bucketStart(qint64 epochSeconds, RollupGranularity granularity);
+
+private:
+    struct SlotBuckets {
+        std::map<qint64, RollupBucket> hourly;
+        std::map<qint64, RollupBucket> daily;
+        std::map<qint64, RollupBucket> monthly;
+
+        std::map<qint64, RollupBucket>& of(RollupGranularity granularity);
+        const std::map<qint64, RollupBucket>& of(RollupGranularity granularity) const;
+    };
+
+    QString logDir_;
+    QString path_;
+    QHash<QString, SlotBuckets> slots_;
+    QSet<QString> sessions_;   // 取り込み済みのセッション
+};
+
+#endif // HISTORY_ROLLUP_H
@@ -1,54 +1,123 @@
-#include "config_manager.h"
-#include "log_parser.h"
+#include <QHashFunctions>
+#include <QtNumeric>
 
-QRegularExpression LogParser::timeExp(R"(\[\d{2}:\d{2}:\d{2}\])");
-QRegularExpression LogParser::payExp(R"(^([\d,]+)円支払いました$)");
-QRegularExpression LogParser::gainExp(R"(^([\d,]+)円受け取りました$)");
-QRegularExpression LogParser::loseExp(R"(^\[Man10Slot\]外れました$)");
-QRegularExpression LogParser::roleExp(R"(^\[Man10Slot\]おめでとうございます！(.+)です！$)");
+#include "log_parser.h"
 
+namespace {
 
-LogParser::LogParser(const QString& chatPrefix)
-    : chatPrefix_(chatPrefix), prefixLength_(chatPrefix.length()) {}
+bool isAsciiDigit(QChar c)
+{
+    return c.unicode() >= u'0' && c.unicode() <= u'9';
+}
 
-std::optional<GambleLog> LogParser::parseLine(const QString& line) {
-    QRegularExpressionMatch m;
+// "1,234" 形式の金額。数字とカンマ以外を含む・数字がない・64bit に収まらない場合は失敗
+bool parseAmount(QStringView text, qint64& amount)
+{
+    qint64 value = 0;
+    bool hasDigit = false;
+    for (QChar c : text) {
+        if (c == u',') continue;
+        if (!isAsciiDigit(c)) return false;
+        if (qMulOverflow(value, qint64(10), &value)
+            || qAddOverflow(value, qint64(c.unicode() - u'0'), &value))
+            return false;
+        hasDigit = true;
+    }
+    if (!hasDigit) return false;
+    amount = value;
+    return true;
+}
 
-    // チャットプレフィックス検出
-    int chatIndex = line.indexOf(chatPrefix_);
-    if (chatIndex == -1) return std::nullopt; 
+// 行内の最初の [HH:MM:SS] を秒数に変換
+qint32 findTime(QStringView line)
+{
+    for (qsizetype i = line.indexOf(u'['); i >= 0 && i + 10 <= line.size(); i = line.indexOf(u'[', i + 1)) {
+        QStringView t = line.mid(i, 10);
+        if (t[3] != u':' || t[6] != u':' || t[9] != u']') continue;
+        if (!isAsciiDigit(t[1]) || !isAsciiDigit(t[2]) || !isAsciiDigit(t[4])
+            || !isAsciiDigit(t[5]) || !isAsciiDigit(t[7]) || !isAsciiDigit(t[8]))
+            continue;
 
-    // チャット本文抽出
-    QString body = line.mid(chatIndex + chatPrefix_.length()).trimmed();
-    
-    GambleLog log;
-    log.content = body;
+        auto two = [&](int at) { return (t[at].unicode() - u'0') * 10 + (t[at + 1].unicode() - u'0'); };
+        return two(1) * 3600 + two(4) * 60 + two(7);
+    }
+    return kNoLogTime;
+}
 
-    if ((m = timeExp.match(line)).hasMatch())
-        log.time = m.captured(0);
+} // namespace
 
-    if ((m = payExp.match(body)).hasMatch()) {
-        log.type = GambleLogType::Payment;
-        log.amount = m.captured(1).remove(",").toInt();
-        return log;
+quint32 RoleTable::find(QStringView name) const
+{
+    const auto range = idsByHash_.equal_range(qHash(name));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (names_.at(*it) == name)
+            return *it;
     }
+    return kNoRole;
+}
 
-    if ((m = gainExp.match(body)).hasMatch()) {
-        log.type = GambleLogType::Gain;
-        log.amount = m.captured(1).remove(",").toInt();
-        return log;
-    }
+quint32 RoleTable::intern(QStringView name)
+{
+    const quint32 existing = find(name);
+    if (existing != kNoRole) return existing;
 
-    if ((m = loseExp.match(body)).hasMatch()) {
-        log.type = GambleLogType::Lose;
-        return log;
-    }
+    const size_t hash = qHash(name);
+
+    const quint32 id = static_cast<quint32>(names_.size());
+    names_.append(name.toString());
+    idsByHash_.insert(hash, id);
+    return id;
+}
+
+void GambleLogBatch::clear()
+{
+    logs.clear();
+    arena.truncate(0);
+}
+
+QString formatLogTime(qint32 secondsOfDay)
+{
+    if (secondsOfDay < 0) return QString();
+    return QString("[%1:%2:%3]")
+        .arg(secondsOfDay / 3600, 2, 10, QChar('0'))
+        .arg(secondsOfDay / 60 % 60, 2, 10, QChar('0'))
+        .arg(secondsOfDay % 60, 2, 10, QChar('0'));
+}
+
+LogParser::LogParser(const QString& chatPrefix, const QList<ParseRuleConfig>& rules, RoleTable* roles)
+    : chatPrefix_(chatPrefix), matcher_(rules), roles_(roles) {}
+
+bool LogParser::parseLine(QStringView line, GambleLogBatch& batch) {
+    // チャットプレフィックス検出
+    qsizetype chatIndex = line.indexOf(chatPrefix_);
+    if (chatIndex == -1) return false;
+
+    // チャット本文抽出
+    QStringView body = line.mid(chatIndex + chatPrefix_.length()).trimmed();
+
+    ParseRuleMatch match;
+    if (!matcher_.match(body, match)) return false;
+
+    GambleLog log;
+    log.type = match.type;
 
-    if ((m = roleExp.match(body)).hasMatch()) {
-        log.type = GambleLogType::Role;
-        log.roleName = m.captured(1).trimmed();
-        return log;
+    switch (log.type) {
+    case GambleLogType::Payment:
+    case GambleLogType::Gain:
+        if (!parseAmount(match.amount, log.amount)) return false;
+        break;
+    case GambleLogType::Role:
+        if (match.role.isEmpty()) return false;
+        log.roleId = roles_->intern(match.role);
+        break;
+    default:
+        break;
     }
 
-    return std::nullopt;
+    log.secondsOfDay = findTime(line);
+    log.contentOffset = static_cast<quint32>(batch.arena.size());
+    log.contentLength = static_cast<quint32>(body.size());
+    batch.arena.append(body);
+    batch.logs.push_back(log);
+    return true;
 }
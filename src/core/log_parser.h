@@ -1,9 +1,13 @@
 #ifndef LOGPARSER_H
 #define LOGPARSER_H
 
+#include <QMultiHash>
 #include <QString>
-#include <QRegularExpression>
-#include <optional>
+#include <QStringList>
+#include <QStringView>
+#include <vector>
+
+#include "parse_rules.h"
 
 enum class GambleLogType {
     Payment,
@@ -12,29 +16,64 @@ enum class GambleLogType {
     Role
 };
 
+constexpr qint32 kNoLogTime = -1;
+constexpr quint32 kNoRole = 0xFFFFFFFFu;
+
+// 1行分のイベント。文字列は持たず、本文はバッチのアリーナへのオフセットで参照する
 struct GambleLog {
-    GambleLogType type;
-    int amount = 0;              // 支払 or 受取
-    QString roleName;           // 当たり役名
-    QString time;               // [HH:MM:SS]
-    QString content;            // 元のログ内容（プレフィックス除去後）
+    GambleLogType type = GambleLogType::Payment;
+    qint32 secondsOfDay = kNoLogTime;   // [HH:MM:SS] を 0時からの秒数で
+    qint64 amount = 0;                  // 支払 or 受取
+    quint32 roleId = kNoRole;           // 当たり役 ID（RoleTable）
+    quint32 contentOffset = 0;          // 元のログ内容（プレフィックス除去後）
+    quint32 contentLength = 0;
+};
+
+// 役名 ⇔ ID の対応表。ID はセッション中は変わらない
+class RoleTable {
+public:
+    quint32 intern(QStringView name);
+    quint32 find(QStringView name) const;  // 未登録なら kNoRole
+    const QString& name(quint32 id) const { return names_.at(id); }
+    int size() const { return names_.size(); }
+
+private:
+    QStringList names_;
+    QMultiHash<size_t, quint32> idsByHash_;
 };
 
+// 1回の読み込み分のイベント。clear() しても確保済みの領域は再利用する
+class GambleLogBatch {
+public:
+    void clear();
+    bool isEmpty() const { return logs.empty(); }
+
+    QStringView content(const GambleLog& log) const {
+        return QStringView(arena).mid(log.contentOffset, log.contentLength);
+    }
+    QString roleName(const GambleLog& log) const {
+        return (roles && log.roleId != kNoRole) ? roles->name(log.roleId) : QString();
+    }
+
+    std::vector<GambleLog> logs;
+    QString arena;                      // 本文を連結したバッファ
+    const RoleTable* roles = nullptr;
+};
+
+// "[HH:MM:SS]" 形式に戻す（表示用）。時刻なしなら空文字列
+QString formatLogTime(qint32 secondsOfDay);
+
 class LogParser {
 public:
-    explicit LogParser(const QString& chatPrefix);
+    LogParser(const QString& chatPrefix, const QList<ParseRuleConfig>& rules, RoleTable* roles);
 
-    std::optional<GambleLog> parseLine(const QString& line);
+    // 解析できた行は batch に追加して true を返す
+    bool parseLine(QStringView line, GambleLogBatch& batch);
 
 private:
     QString chatPrefix_;
-    int prefixLength_;
-
-    static QRegularExpression timeExp;
-    static QRegularExpression payExp;
-    static QRegularExpression gainExp;
-    static QRegularExpression loseExp;
-    static QRegularExpression roleExp;
+    ParseRuleMatcher matcher_;
+    RoleTable* roles_;
 };
 
-#endif // LOGPARSER_H
\ No newline at end of file
+#endif // LOGPARSER_H
@@ -1,27 +1,27 @@
-#include <QTextStream>
-#include <QTextCodec>
-
 #include "config_manager.h" 
 #include "log_watcher.h"
 
+namespace {
+
+// 大量の追記を読むときもこの件数ごとに通知してバッチを使い回す
+constexpr size_t kMaxBatchLogs = 4096;
+
+} // namespace
+
 LogWatcher::LogWatcher(QObject* parent)
     : QObject(parent)
     , timer_(new QTimer(this))
 {
-    ConfigManager& config = ConfigManager::instance();
-    // 設定読み込み
-    filePath_ = config.get("FilePath").toString();
-    encoding_ = config.get("Encoding").toString();
-    updateInterval_ = config.get("LogUpdateInterval").toInt();
-
-    QString chatPrefix = config.get("ChatPrefix").toString();
-    parser_ = new LogParser(chatPrefix);
+    batch_.roles = &roles_;
+
+    // 設定読み込み（監視対象ファイルは開始時に固定）
+    auto config = ConfigManager::instance().snapshot();
+    filePath_ = config->filePath;
+    applyConfig(config);
 }
 
 LogWatcher::~LogWatcher() {
-    if (file_.isOpen()) {
-        file_.close();
-    }
+    reader_.close();
 }
 
 void LogWatcher::start() {
@@ -29,50 +29,66 @@ void LogWatcher::start() {
     timer_->start(updateInterval_);
 }
 
-void LogWatcher::reopen(const QString& path) {
-    if (!QFile::exists(path)) return;
-    if (file_.isOpen()) file_.close();
+bool LogWatcher::reopen(const QString& path) {
+    if (!QFile::exists(path)) return false;
+    return reader_.open(path);
+}
+
+void LogWatcher::applyConfig(const std::shared_ptr<const ConfigSnapshot>& config) {
+    if (!config_ || config_->chatPrefix != config->chatPrefix || config_->parseRules != config->parseRules)
+        parser_ = std::make_unique<LogParser>(config->chatPrefix, config->parseRules, &roles_);
 
-    file_.setFileName(path);
-    file_.open(QIODevice::ReadOnly | QIODevice::Text);
-    
-    if (!file_.isOpen()) return;
+    if (!decoder_ || encoding_ != config->encoding) {
+        decoder_ = std::make_unique<TextDecoder>(config->encoding);
+        encoding_ = config->encoding;
+    }
+
+    if (updateInterval_ != config->logUpdateInterval) {
+        updateInterval_ = config->logUpdateInterval;
+        if (timer_->isActive())
+            timer_->setInterval(updateInterval_);
+    }
 
-    size_ = file_.size();
+    config_ = config;
 }
 
 void LogWatcher::check() {
     if (paused_) return; 
 
-    if (!file_.isOpen()) {
-        reopen(filePath_);
-        pos_ = size_;
-    }
+    // 設定が更新されていれば反映（読み取り位置は維持するので行は失われない）
+    auto config = ConfigManager::instance().snapshot();
+    if (config != config_)
+        applyConfig(config);
 
-    if (file_.size() < size_) {
+    if (!reader_.isOpen()) {
+        if (!reopen(filePath_)) return;
+        reader_.seekToEnd();
+    } else if (reader_.isTruncated()) {
         // ローテーション検知
-        reopen(filePath_);
-        pos_ = 0;
-        file_.seek(0);
-    } else {
-        file_.seek(pos_);
+        if (!reopen(filePath_)) return;
     }
 
-    QByteArray rawData = file_.readAll();
-    if (rawData.isEmpty()) return;
+    batch_.clear();
 
-    size_ = file_.size();
-    pos_ = file_.pos();
+    QByteArrayView line;
+    while (reader_.nextLine(line)) {
+        // 行単位で読んでいるのでデコーダの持ち越しは不要
+        decoder_->reset();
+        lineText_.truncate(0);
+        decoder_->decode(line.data(), line.size(), lineText_);
 
-    QTextCodec* codec = QTextCodec::codecForName(encoding_.toUtf8());
-    QString logText = codec ? codec->toUnicode(rawData) : QString::fromUtf8(rawData);
+        QStringView text = QStringView(lineText_).trimmed();
+        if (!text.isEmpty())
+            parser_->parseLine(text, batch_);
 
-    QStringList lines = logText.split("\n", Qt::SkipEmptyParts);
-    for (const QString& line : lines) {
-        if (auto parsed = parser_->parseLine(line.trimmed())) {
-            emit newLogLine(*parsed);
+        if (batch_.logs.size() >= kMaxBatchLogs) {
+            emit newLogBatch(batch_);
+            batch_.clear();
         }
     }
+
+    if (!batch_.isEmpty())
+        emit newLogBatch(batch_);
 }
 
 void LogWatcher::pause() {
@@ -80,16 +96,12 @@ void LogWatcher::pause() {
 }
 
 void LogWatcher::resume() {
-    if (!file_.isOpen()) {
+    if (!reader_.isOpen()) {
         reopen(filePath_);
     }
 
     // 現在の末尾まで読み飛ばす
-    if (file_.isOpen()) {
-        file_.seek(file_.size());
-        pos_ = file_.pos();
-        size_ = file_.size();
-    }
+    reader_.seekToEnd();
 
     paused_ = false;
 }
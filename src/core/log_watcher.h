@@ -2,11 +2,15 @@
 #define LOGWATCHER_H
 
 #include <QObject>
-#include <QFile>
 #include <QTimer>
 #include <QString>
+#include <memory>
 
 #include "log_parser.h"
+#include "tail_reader.h"
+#include "text_decoder.h"
+
+struct ConfigSnapshot;
 
 class LogWatcher : public QObject {
     Q_OBJECT
@@ -19,27 +23,34 @@ public:
     void pause();
     void resume();
 
+    const RoleTable& roles() const { return roles_; }
+
 signals:
-    void newLogLine(const GambleLog& log);
+    // 1回の読み込みで解析できたイベントをまとめて通知（batch は次の読み込みまで有効）
+    void newLogBatch(const GambleLogBatch& batch);
 
 private slots:
     void check();
 
 private:
-    void reopen(const QString& path);
+    bool reopen(const QString& path);
     bool isPaused() const;
+    void applyConfig(const std::shared_ptr<const ConfigSnapshot>& config);
 
-    QFile file_;
+    TailReader reader_;
     QTimer* timer_;
-    qint64 pos_ = 0;
-    qint64 size_ = 0;
     bool paused_ = false;
 
-    int updateInterval_;
+    std::shared_ptr<const ConfigSnapshot> config_;  // 適用済みの設定
+    int updateInterval_ = 100;
     QString filePath_;
     QString encoding_;
 
-    LogParser* parser_;
+    RoleTable roles_;
+    GambleLogBatch batch_;
+    std::unique_ptr<LogParser> parser_;
+    std::unique_ptr<TextDecoder> decoder_;
+    QString lineText_;  // 1行分のデコード結果（使い回す）
 };
 
 #endif // LOGWATCHER_H
\ No newline at end of file
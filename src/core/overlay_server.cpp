@@ -0,0 +1,315 @@
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "overlay_server.h"
+
+namespace {
+
+constexpr int kFrameIntervalMs = 16;
+constexpr qint64 kMaxRequestSize = 8 * 1024;
+constexpr int kRequestTimeoutMs = 5000;           // 接続してからリクエストを送り終えるまでの猶予
+constexpr qint64 kMaxPendingBytes = 1024 * 1024;  // これ以上溜まる購読者は切断
+
+// GET / で返すオーバーレイ本体。/events と同じオリジンから読むので CORS は要らない
+// OBS のブラウザソースには http://127.0.0.1:<port>/ を指定する
+constexpr char kOverlayPage[] = R"html(<!DOCTYPE html>
+<html lang="ja">
+<head>
+<meta charset="utf-8">
+<title>GambleLive</title>
+<style>
+body { margin: 0; background: transparent; color: #fff; font: bold 20px sans-serif; text-shadow: 0 0 4px #000; }
+#overlay { padding: 8px 12px; }
+#slot { font-size: 24px; }
+.minus { color: #ff6b6b; }
+.plus { color: #7cff8a; }
+#roles div { font-size: 16px; }
+</style>
+</head>
+<body>
+<div id="overlay">
+<div id="slot"></div>
+<div>回転数 <span id="spins">0</span></div>
+<div>使用 <span id="spent">0</span> 円 / 獲得 <span id="gained">0</span> 円</div>
+<div>収支 <span id="net">0</span> 円</div>
+<div id="roles"></div>
+</div>
+<script>
+const roles = {};
+const text = (id, value) => { document.getElementById(id).textContent = value; };
+const yen = (value) => Number(value).toLocaleString("ja-JP");
+function apply(data) {
+  if (data.full) {
+    for (const key in roles) delete roles[key];
+    text("slot", data.slot || "");
+  }
+  if ("spent" in data) {
+    text("spins", yen(data.spins));
+    text("spent", yen(data.spent));
+    text("gained", yen(data.gained));
+    text("net", (data.net > 0 ? "+" : "") + yen(data.net));
+    document.getElementById("net").className = data.net < 0 ? "minus" : "plus";
+  }
+  if (data.roles) {
+    Object.assign(roles, data.roles);
+    const list = document.getElementById("roles");
+    list.replaceChildren(...Object.keys(roles).map((role) => {
+      const row = document.createElement("div");
+      row.textContent = role + " " + roles[role];
+      return row;
+    }));
+  }
+}
+new EventSource("/events").onmessage = (event) => apply(JSON.parse(event.data));
+</script>
+</body>
+</html>
+)html";
+
+} // namespace
+
+OverlayServer::OverlayServer(QObject *parent)
+    : QObject(parent)
+    , server_(new QTcpServer(this))
+    , frameTimer_(new QTimer(this))
+{
+    frameTimer_->setSingleShot(true);
+    frameTimer_->setInterval(kFrameIntervalMs);
+    connect(frameTimer_, &QTimer::timeout, this, &OverlayServer::flush);
+    connect(server_, &QTcpServer::newConnection, this, &OverlayServer::onNewConnection);
+}
+
+bool OverlayServer::listen(quint16 port)
+{
+    return server_->listen(QHostAddress::LocalHost, port);
+}
+
+bool OverlayServer::isListening() const
+{
+    return server_->isListening();
+}
+
+void OverlayServer::reset(const QString &slotName)
+{
+    slotName_ = slotName;
+    spent_ = 0;
+    gained_ = 0;
+    spins_ = 0;
+    roleCount_.clear();
+    dirtyRoles_.clear();
+    statsDirty_ = false;
+
+    // 購読者には新しい全体スナップショットを送り直す
+    const QByteArray event = QJsonDocument(snapshotJson()).toJson(QJsonDocument::Compact);
+    const QList<QTcpSocket *> subscribers = subscribers_;  // 送信中の切断に備えてコピー
+    for (QTcpSocket *socket : subscribers)
+        sendEvent(socket, event);
+}
+
+void OverlayServer::setStats(qint64 spent, qint64 gained, int spins)
+{
+    if (spent == spent_ && gained == gained_ && spins == spins_) return;
+    spent_ = spent;
+    gained_ = gained;
+    spins_ = spins;
+    statsDirty_ = true;
+    scheduleFlush();
+}
+
+void OverlayServer::setRoleCount(const QString &role, int count)
+{
+    roleCount_[role] = count;
+    dirtyRoles_.insert(role);
+    scheduleFlush();
+}
+
+void OverlayServer::scheduleFlush()
+{
+    if (!frameTimer_->isActive())
+        frameTimer_->start();
+}
+
+void OverlayServer::flush()
+{
+    if (!statsDirty_ && dirtyRoles_.isEmpty()) return;
+
+    QJsonObject delta;
+    delta["seq"] = static_cast<qint64>(++sequence_);
+    if (statsDirty_) {
+        delta["spent"] = spent_;
+        delta["gained"] = gained_;
+        delta["net"] = gained_ - spent_;
+        delta["spins"] = spins_;
+    }
+    if (!dirtyRoles_.isEmpty()) {
+        QJsonObject roles;
+        for (const QString &role : std::as_const(dirtyRoles_))
+            roles[role] = roleCount_.value(role);
+        delta["roles"] = roles;
+    }
+    statsDirty_ = false;
+    dirtyRoles_.clear();
+
+    // JSON は1回だけ組み立てて全購読者へ送る
+    const QByteArray event = QJsonDocument(delta).toJson(QJsonDocument::Compact);
+    const QList<QTcpSocket *> subscribers = subscribers_;  // 送信中の切断に備えてコピー
+    for (QTcpSocket *socket : subscribers)
+        sendEvent(socket, event);
+}
+
+QJsonObject OverlayServer::snapshotJson() const
+{
+    QJsonObject roles;
+    for (auto it = roleCount_.cbegin(); it != roleCount_.cend(); ++it)
+        roles[it.key()] = it.value();
+
+    return QJsonObject{
+        {"seq", static_cast<qint64>(sequence_)},
+        {"full", true},
+        {"slot", slotName_},
+        {"spent", spent_},
+        {"gained", gained_},
+        {"net", gained_ - spent_},
+        {"spins", spins_},
+        {"roles", roles},
+    };
+}
+
+void OverlayServer::onNewConnection()
+{
+    while (QTcpSocket *socket = server_->nextPendingConnection()) {
+        requestBuffers_.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, &OverlayServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &OverlayServer::onDisconnected);
+
+        // 何も送ってこない接続を残さない
+        QTimer::singleShot(kRequestTimeoutMs, socket, [this, socket]() {
+            if (requestBuffers_.remove(socket))
+                socket->abort();
+        });
+    }
+}
+
+void OverlayServer::onReadyRead()
+{
+    auto *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket) return;
+
+    auto it = requestBuffers_.find(socket);
+    if (it == requestBuffers_.end()) {
+        socket->readAll();  // 購読中の接続からの入力は無視
+        return;
+    }
+
+    it->append(socket->readAll());
+    const qsizetype headerEnd = it->indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (it->size() > kMaxRequestSize) {
+            requestBuffers_.erase(it);
+            socket->abort();
+        }
+        return;
+    }
+
+    const QList<QByteArray> headerLines = it->left(headerEnd).split('\n');
+    requestBuffers_.erase(it);
+
+    const QList<QByteArray> requestLine = headerLines.first().trimmed().split(' ');
+    if (requestLine.size() < 2) {
+        sendResponse(socket, "400 Bad Request", QByteArray());
+        return;
+    }
+
+    // DNS リバインディング対策。Host が自分自身（localhost / 127.0.0.1）でなければ断る
+    QByteArray host;
+    for (qsizetype i = 1; i < headerLines.size(); ++i) {
+        const QByteArray line = headerLines[i].trimmed();
+        const qsizetype colon = line.indexOf(':');
+        if (colon > 0 && line.left(colon).trimmed().toLower() == "host")
+            host = line.mid(colon + 1).trimmed().toLower();
+    }
+    if (!isLocalHost(host)) {
+        sendResponse(socket, "403 Forbidden", QByteArray());
+        return;
+    }
+
+    handleRequest(socket, requestLine[0], requestLine[1]);
+}
+
+bool OverlayServer::isLocalHost(const QByteArray &host) const
+{
+    const QByteArray port = QByteArray::number(server_->serverPort());
+    for (const QByteArray name : { QByteArray("localhost"), QByteArray("127.0.0.1") }) {
+        if (host == name + ':' + port) return true;
+        if (port == "80" && host == name) return true;   // 既定のポートは省略される
+    }
+    return false;
+}
+
+void OverlayServer::handleRequest(QTcpSocket *socket, const QByteArray &method, const QByteArray &path)
+{
+    if (method != "GET") {
+        sendResponse(socket, "405 Method Not Allowed", QByteArray());
+        return;
+    }
+
+    const QByteArray route = path.left(path.indexOf('?') >= 0 ? path.indexOf('?') : path.size());
+
+    if (route == "/") {
+        sendResponse(socket, "200 OK", QByteArray(kOverlayPage), "text/html");
+        return;
+    }
+
+    if (route == "/snapshot") {
+        sendResponse(socket, "200 OK", QJsonDocument(snapshotJson()).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    if (route == "/events") {
+        socket->write("HTTP/1.1 200 OK\r\n"
+                      "Content-Type: text/event-stream; charset=utf-8\r\n"
+                      "Cache-Control: no-cache\r\n"
+                      "Connection: keep-alive\r\n"
+                      "\r\n");
+        subscribers_.append(socket);
+        sendEvent(socket, QJsonDocument(snapshotJson()).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    sendResponse(socket, "404 Not Found", QByteArray());
+}
+
+void OverlayServer::sendResponse(QTcpSocket *socket, const QByteArray &status, const QByteArray &body,
+                                 const QByteArray &contentType)
+{
+    QByteArray response = "HTTP/1.1 " + status + "\r\n"
+        "Content-Type: " + contentType + "; charset=utf-8\r\n"
+        "Connection: close\r\n"
+        "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+        "\r\n" + body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+void OverlayServer::sendEvent(QTcpSocket *socket, const QByteArray &event)
+{
+    // 読み出しが追いつかない購読者は切断して取り込みを妨げない
+    if (socket->bytesToWrite() > kMaxPendingBytes) {
+        socket->abort();
+        return;
+    }
+    socket->write("data: " + event + "\n\n");
+}
+
+void OverlayServer::onDisconnected()
+{
+    auto *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket) return;
+
+    subscribers_.removeAll(socket);
+    requestBuffers_.remove(socket);
+    socket->deleteLater();
+}
@@ -0,0 +1,70 @@
+#ifndef OVERLAY_SERVER_H
+#define OVERLAY_SERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+// 配信オーバーレイ向けのローカル HTTP サーバ（127.0.0.1 のみ）
+//   GET /         : オーバーレイの HTML（OBS のブラウザソースに指定する）
+//   GET /snapshot : 現在の統計を JSON で返す
+//   GET /events   : Server-Sent Events。接続時に全体、以降は変更分だけを送る
+// 変更は1フレーム（約16ms）ごとにまとめて全購読者へ送る
+// Host が localhost / 127.0.0.1 以外のリクエストは断り、CORS ヘッダは付けない
+// （ページは / から同じオリジンで配るので、他のサイトからは読めない）
+class OverlayServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OverlayServer(QObject *parent = nullptr);
+
+    bool listen(quint16 port);
+    bool isListening() const;
+
+public slots:
+    void reset(const QString &slotName);
+    void setStats(qint64 spent, qint64 gained, int spins);
+    void setRoleCount(const QString &role, int count);
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void flush();
+
+private:
+    void scheduleFlush();
+    bool isLocalHost(const QByteArray &host) const;
+    void handleRequest(QTcpSocket *socket, const QByteArray &method, const QByteArray &path);
+    void sendResponse(QTcpSocket *socket, const QByteArray &status, const QByteArray &body,
+                      const QByteArray &contentType = "application/json");
+    void sendEvent(QTcpSocket *socket, const QByteArray &event);
+    QJsonObject snapshotJson() const;
+
+    QTcpServer *server_;
+    QTimer *frameTimer_;
+    QList<QTcpSocket *> subscribers_;
+    QHash<QTcpSocket *, QByteArray> requestBuffers_;  // ヘッダ受信途中の接続
+
+    QString slotName_;
+    qint64 spent_ = 0;
+    qint64 gained_ = 0;
+    int spins_ = 0;
+    QMap<QString, int> roleCount_;
+
+    bool statsDirty_ = false;
+    QSet<QString> dirtyRoles_;
+    quint64 sequence_ = 0;
+};
+
+#endif // OVERLAY_SERVER_H
@@ -0,0 +1,18 @@
+#ifndef PARSE_RULE_CONFIG_H
+#define PARSE_RULE_CONFIG_H
+
+#include <QString>
+
+// パースルール1件（ParseRules の各ルールセットを平坦化したもの）
+struct ParseRuleConfig {
+    QString ruleSet;   // ルールセット名（プラグイン名など）
+    QString type;      // Payment / Gain / Lose / Role
+    QString pattern;   // {amount} / {role} を含むチャット本文のパターン
+
+    bool operator==(const ParseRuleConfig& other) const {
+        return ruleSet == other.ruleSet && type == other.type && pattern == other.pattern;
+    }
+    bool operator!=(const ParseRuleConfig& other) const { return !(*this == other); }
+};
+
+#endif // PARSE_RULE_CONFIG_H
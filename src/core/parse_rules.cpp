@@ -0,0 +1,190 @@
+#include <QDebug>
+#include <algorithm>
+
+#include "log_parser.h"
+#include "parse_rules.h"
+
+namespace {
+
+constexpr QStringView kAmountToken = u"{amount}";
+constexpr QStringView kRoleToken = u"{role}";
+
+bool isAmountChar(QChar c)
+{
+    return (c.unicode() >= u'0' && c.unicode() <= u'9') || c == u',';
+}
+
+int typeFromName(const QString& name)
+{
+    if (name == "Payment") return static_cast<int>(GambleLogType::Payment);
+    if (name == "Gain") return static_cast<int>(GambleLogType::Gain);
+    if (name == "Lose") return static_cast<int>(GambleLogType::Lose);
+    if (name == "Role") return static_cast<int>(GambleLogType::Role);
+    return -1;
+}
+
+} // namespace
+
+ParseRuleMatcher::ParseRuleMatcher(const QList<ParseRuleConfig>& rules)
+{
+    nodes_.emplace_back();  // 根
+
+    for (const ParseRuleConfig& rule : rules) {
+        if (addRule(rule)) {
+            ++ruleCount_;
+        } else {
+            qWarning() << "パースルールを無視しました:" << rule.ruleSet << rule.type << rule.pattern;
+        }
+    }
+}
+
+int ParseRuleMatcher::child(int node, char16_t c) const
+{
+    const auto& next = nodes_[node].next;
+    auto it = std::lower_bound(next.begin(), next.end(), c,
+        [](const std::pair<char16_t, int>& edge, char16_t key) { return edge.first < key; });
+    return (it != next.end() && it->first == c) ? it->second : -1;
+}
+
+int ParseRuleMatcher::addChild(int node, char16_t c)
+{
+    int existing = child(node, c);
+    if (existing >= 0) return existing;
+
+    const int created = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();  // nodes_ の再確保後に参照を取る
+    auto& next = nodes_[node].next;
+    auto it = std::lower_bound(next.begin(), next.end(), c,
+        [](const std::pair<char16_t, int>& edge, char16_t key) { return edge.first < key; });
+    next.insert(it, { c, created });
+    return created;
+}
+
+bool ParseRuleMatcher::addRule(const ParseRuleConfig& rule)
+{
+    const int type = typeFromName(rule.type);
+    if (type < 0) return false;
+
+    QStringView pattern(rule.pattern);
+    const qsizetype amountAt = pattern.indexOf(kAmountToken);
+    const qsizetype roleAt = pattern.indexOf(kRoleToken);
+
+    // 金額系は {amount}、役は {role} が必須で、それ以外の種別には置けない
+    // （1つのパターンに両方が入ることはないので {role} 以降はリテラルだけになる）
+    const bool needsAmount = type == static_cast<int>(GambleLogType::Payment)
+                          || type == static_cast<int>(GambleLogType::Gain);
+    const bool needsRole = type == static_cast<int>(GambleLogType::Role);
+    if (needsAmount != (amountAt >= 0) || needsRole != (roleAt >= 0)) return false;
+
+    int node = 0;
+    qsizetype i = 0;
+    while (i < pattern.size()) {
+        if (pattern.mid(i).startsWith(kAmountToken)) {
+            if (nodes_[node].amountNext < 0) {
+                const int created = static_cast<int>(nodes_.size());
+                nodes_.emplace_back();
+                nodes_[node].amountNext = created;
+            }
+            node = nodes_[node].amountNext;
+            i += kAmountToken.size();
+        } else if (pattern.mid(i).startsWith(kRoleToken)) {
+            if (nodes_[node].roleSuffixRoot < 0) {
+                const int created = static_cast<int>(nodes_.size());
+                nodes_.emplace_back();
+                nodes_[node].roleSuffixRoot = created;
+            }
+            // 残りの接尾辞を逆順に登録
+            int suffixNode = nodes_[node].roleSuffixRoot;
+            QStringView suffix = pattern.mid(i + kRoleToken.size());
+            for (qsizetype j = suffix.size() - 1; j >= 0; --j)
+                suffixNode = addChild(suffixNode, suffix[j].unicode());
+            if (nodes_[suffixNode].accept >= 0) return false;  // 同じパターンが登録済み
+            nodes_[suffixNode].accept = type;
+            return true;
+        } else {
+            node = addChild(node, pattern[i].unicode());
+            ++i;
+        }
+    }
+
+    if (nodes_[node].accept >= 0) return false;
+    nodes_[node].accept = type;
+    return true;
+}
+
+bool ParseRuleMatcher::match(QStringView body, ParseRuleMatch& result) const
+{
+    Captures captures;
+    const int type = matchFrom(0, body, 0, captures);
+    if (type < 0) return false;
+
+    result.type = static_cast<GambleLogType>(type);
+    result.amount = captures.amountBegin >= 0
+        ? body.mid(captures.amountBegin, captures.amountEnd - captures.amountBegin) : QStringView();
+    result.role = captures.roleBegin >= 0
+        ? body.mid(captures.roleBegin, captures.roleEnd - captures.roleBegin).trimmed() : QStringView();
+    return true;
+}
+
+int ParseRuleMatcher::matchFrom(int node, QStringView body, qsizetype pos, Captures& captures) const
+{
+    while (true) {
+        const Node& n = nodes_[node];
+        if (pos == body.size() && n.accept >= 0) return n.accept;
+
+        // 分岐があるノードではリテラル → {amount} → {role} の順に試す
+        if (n.amountNext >= 0 || n.roleSuffixRoot >= 0) {
+            if (pos < body.size()) {
+                int next = child(node, body[pos].unicode());
+                if (next >= 0) {
+                    int type = matchFrom(next, body, pos + 1, captures);
+                    if (type >= 0) return type;
+                }
+            }
+            if (n.amountNext >= 0 && pos < body.size() && isAmountChar(body[pos])) {
+                qsizetype end = pos;
+                while (end < body.size() && isAmountChar(body[end])) ++end;
+                const Captures saved = captures;
+                captures.amountBegin = pos;
+                captures.amountEnd = end;
+                int type = matchFrom(n.amountNext, body, end, captures);
+                if (type >= 0) return type;
+                captures = saved;
+            }
+            if (n.roleSuffixRoot >= 0)
+                return matchRoleSuffix(n.roleSuffixRoot, body, pos, captures);
+            return -1;
+        }
+
+        if (pos >= body.size()) return -1;
+        node = child(node, body[pos].unicode());
+        if (node < 0) return -1;
+        ++pos;
+    }
+}
+
+int ParseRuleMatcher::matchRoleSuffix(int root, QStringView body, qsizetype roleBegin, Captures& captures) const
+{
+    // 末尾から逆順トライをたどり、役名が空にならない最長の接尾辞を採用する
+    int best = -1;
+    qsizetype bestEnd = -1;
+
+    int node = root;
+    qsizetype pos = body.size();
+    while (node >= 0) {
+        const int accept = nodes_[node].accept;
+        if (accept >= 0 && pos > roleBegin && !body.mid(roleBegin, pos - roleBegin).trimmed().isEmpty()) {
+            best = accept;
+            bestEnd = pos;
+        }
+        if (pos <= roleBegin) break;
+        node = child(node, body[pos - 1].unicode());
+        --pos;
+    }
+
+    if (best >= 0) {
+        captures.roleBegin = roleBegin;
+        captures.roleEnd = bestEnd;
+    }
+    return best;
+}
@@ -0,0 +1,58 @@
+#ifndef PARSE_RULES_H
+#define PARSE_RULES_H
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <utility>
+#include <vector>
+
+#include "parse_rule_config.h"
+
+enum class GambleLogType;
+
+// ルールに一致した結果
+struct ParseRuleMatch {
+    GambleLogType type;
+    QStringView amount;   // {amount} の部分（カンマ込み）
+    QStringView role;     // {role} の部分
+};
+
+// 設定のパースルールを1つのトライにまとめた照合器
+// パターンはチャット本文全体に一致するリテラル文字列で、次のプレースホルダを含められる
+//   {amount} : 数字とカンマの並び（最長一致）
+//   {role}   : 1文字以上の任意の文字列。以降はリテラルのみ
+// 照合コストは本文の長さにほぼ比例し、ルールセットの数には依存しない
+class ParseRuleMatcher {
+public:
+    explicit ParseRuleMatcher(const QList<ParseRuleConfig>& rules);
+
+    bool match(QStringView body, ParseRuleMatch& result) const;
+    int ruleCount() const { return ruleCount_; }
+
+private:
+    struct Node {
+        std::vector<std::pair<char16_t, int>> next;  // 文字 → ノード（文字順）
+        int amountNext = -1;
+        int roleSuffixRoot = -1;  // {role} 以降の接尾辞を逆順に並べたトライの根
+        int accept = -1;          // 受理するルールの種別（GambleLogType の値）
+    };
+
+    struct Captures {
+        qsizetype amountBegin = -1;
+        qsizetype amountEnd = -1;
+        qsizetype roleBegin = -1;
+        qsizetype roleEnd = -1;
+    };
+
+    bool addRule(const ParseRuleConfig& rule);
+    int child(int node, char16_t c) const;
+    int addChild(int node, char16_t c);
+    int matchFrom(int node, QStringView body, qsizetype pos, Captures& captures) const;
+    int matchRoleSuffix(int root, QStringView body, qsizetype roleBegin, Captures& captures) const;
+
+    std::vector<Node> nodes_;
+    int ruleCount_ = 0;
+};
+
+#endif // PARSE_RULES_H
@@ -0,0 +1,192 @@
+#include <algorithm>
+
+#include "compressed_log.h"
+#include "session_log_file.h"
+
+SessionLogFile::SessionLogFile(const QString& path)
+    : file_(path)
+    , reader_(path)
+    , compressed_(path.endsWith(kCompressedSuffix, Qt::CaseInsensitive))
+    , pages_(kCachedPages)
+    , inMemory_(path.isEmpty())
+{
+}
+
+SessionLogFile::~SessionLogFile()
+{
+    if (file_.isOpen()) {
+        if (compressed_)
+            checkpoint();
+        out_.flush();
+        file_.close();
+    }
+}
+
+bool SessionLogFile::open()
+{
+    if (inMemory_) {
+        memoryOpen_ = true;
+        return true;
+    }
+    if (file_.isOpen()) return true;
+
+    if (compressed_) {
+        if (!file_.open(QIODevice::Append)) return false;
+        if (file_.size() == 0)
+            file_.write(CompressedLog::fileHeader());
+        return true;
+    }
+
+    if (!file_.open(QIODevice::Append | QIODevice::Text)) return false;
+
+    out_.setDevice(&file_);
+    return true;
+}
+
+void SessionLogFile::appendLine(const QString& line)
+{
+    if (!isOpen()) return;
+
+    if (lineCount_ % kPageLines == 0) {
+        if (inMemory_) {
+            // 書き終えたページを残し、古いページから捨てる
+            if (lineCount_ > 0)
+                memoryPages_.push_back(std::move(tail_));
+            if (static_cast<int>(memoryPages_.size()) > kMemoryPages) {
+                memoryPages_.pop_front();
+                ++firstMemoryPage_;
+            }
+        } else if (!compressed_) {
+            // ページの先頭位置を記録
+            out_.flush();
+            pageOffsets_.push_back(file_.size());
+        }
+        tail_.clear();
+    }
+
+    if (compressed_) {
+        pending_ += line.toUtf8();
+        pending_ += '\n';
+        ++pendingLines_;
+    } else if (!inMemory_) {
+        out_ << line << "\n";
+    }
+    tail_ << line;
+    ++lineCount_;
+
+    // deflate ストリームはページをまたがない
+    if (compressed_ && lineCount_ % kPageLines == 0)
+        writeChunk(true);
+}
+
+void SessionLogFile::flush()
+{
+    if (!file_.isOpen()) return;
+
+    if (!compressed_)
+        out_.flush();
+    file_.flush();
+}
+
+void SessionLogFile::checkpoint()
+{
+    if (!file_.isOpen() || !compressed_) return;
+    writeChunk(false);
+}
+
+void SessionLogFile::writeChunk(bool endOfPage)
+{
+    if (pendingLines_ == 0 && !endOfPage) return;
+
+    CompressedLog::Chunk chunk;
+    chunk.streamStart = !deflater_.isActive();
+    chunk.lineCount = pendingLines_;
+    chunk.data = deflater_.compress(pending_, endOfPage);
+
+    chunks_.push_back({ file_.size(), lineCount_ - pendingLines_ });
+    file_.write(CompressedLog::encodeChunk(chunk));
+    file_.flush();
+
+    pending_.clear();
+    pendingLines_ = 0;
+}
+
+bool SessionLogFile::readPage(int page, QStringList& lines) const
+{
+    lines.clear();
+    if (page < 0 || page >= fullPageCount()) return false;
+
+    if (inMemory_) {
+        if (page < firstMemoryPage_) return false;
+        lines = memoryPages_[page - firstMemoryPage_];
+        return true;
+    }
+
+    if (!reader_.isOpen() && !reader_.open(QIODevice::ReadOnly)) return false;
+    if (compressed_) return readCompressedPage(page, lines);
+    if (!reader_.seek(pageOffsets_[page])) return false;
+
+    lines.reserve(kPageLines);
+    while (lines.size() < kPageLines) {
+        QByteArray raw = reader_.readLine();
+        if (raw.isEmpty()) break;
+        while (raw.endsWith('\n') || raw.endsWith('\r'))
+            raw.chop(1);
+        lines << QString::fromUtf8(raw);
+    }
+    return lines.size() == kPageLines;
+}
+
+QString SessionLogFile::lineAt(quint32 line) const
+{
+    if (line >= lineCount_) return QString();
+
+    const int page = static_cast<int>(line / kPageLines);
+    const int offset = static_cast<int>(line % kPageLines);
+    if (page >= fullPageCount())
+        return tail_.value(offset);
+    if (inMemory_)
+        return page < firstMemoryPage_ ? QString() : memoryPages_[page - firstMemoryPage_].value(offset);
+
+    if (QStringList* cached = pages_.object(page))
+        return cached->value(offset);
+
+    auto* lines = new QStringList;
+    readPage(page, *lines);
+    const QString text = lines->value(offset);
+    pages_.insert(page, lines);
+    return text;
+}
+
+bool SessionLogFile::hasLine(quint32 line) const
+{
+    if (line >= lineCount_) return false;
+    return !inMemory_ || static_cast<int>(line / kPageLines) >= firstMemoryPage_;
+}
+
+bool SessionLogFile::readCompressedPage(int page, QStringList& lines) const
+{
+    // ページのチャンクを先頭（ストリーム開始）から順に展開する
+    const quint32 firstLine = static_cast<quint32>(page) * kPageLines;
+    auto it = std::lower_bound(chunks_.begin(), chunks_.end(), firstLine, [](const ChunkInfo& chunk, quint32 line) {
+        return chunk.firstLine < line;
+    });
+
+    lines.reserve(kPageLines);
+    CompressedLog::Inflater inflater;
+    CompressedLog::Chunk chunk;
+    QByteArray text;
+    for (; it != chunks_.end() && it->firstLine < firstLine + kPageLines; ++it) {
+        if (!reader_.seek(it->offset) || !CompressedLog::readChunk(reader_, chunk)) return false;
+        if (!inflater.decompress(chunk, text)) return false;
+
+        // 各行は '\n' で終わる
+        for (qsizetype from = 0; from < text.size(); ) {
+            qsizetype end = text.indexOf('\n', from);
+            if (end < 0) end = text.size();
+            lines << QString::fromUtf8(text.constData() + from, end - from);
+            from = end + 1;
+        }
+    }
+    return lines.size() == kPageLines;
+}
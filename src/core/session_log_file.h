@@ -0,0 +1,84 @@
+#ifndef SESSION_LOG_FILE_H
+#define SESSION_LOG_FILE_H
+
+#include <QCache>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <deque>
+#include <vector>
+
+#include "compressed_log.h"
+
+// セッションログ（_log_ ファイル）の書き込みと、任意の行の読み出し
+// kPageLines 行ごとの先頭位置だけを覚えておき（疎なインデックス）、ページ単位で読み直す
+// 書き込み途中の最後のページだけはメモリに持つ
+// 拡張子が kCompressedSuffix なら圧縮形式（compressed_log.h）で書く。圧縮した内容はページの区切りと
+// checkpoint() でファイルに出す（呼び出し側が kCheckpointIntervalMs ごとに呼ぶ）
+// パスが空ならファイルには書かず、直近 kMemoryPages ページだけをメモリに持つ（それより古い行は読めない）
+class SessionLogFile {
+public:
+    static constexpr int kPageLines = 1024;
+    static constexpr int kCachedPages = 8;
+    static constexpr int kMemoryPages = 16;
+    static constexpr int kCheckpointIntervalMs = 10000;
+    static constexpr const char* kCompressedSuffix = ".logz";
+
+    explicit SessionLogFile(const QString& path = QString());
+    ~SessionLogFile();
+
+    bool open();
+    bool isOpen() const { return inMemory_ ? memoryOpen_ : file_.isOpen(); }
+    bool isInMemory() const { return inMemory_; }
+    bool isCompressed() const { return compressed_; }
+    QString path() const { return file_.fileName(); }
+
+    void appendLine(const QString& line);
+    void flush();
+    void checkpoint();   // 圧縮時、未出力の行をチャンクとして書く
+
+    quint32 lineCount() const { return lineCount_; }
+    int fullPageCount() const { return static_cast<int>(lineCount_ / kPageLines); }
+
+    // 書き込み済みのページを読む（最後の未完成ページは tailLines()）
+    bool readPage(int page, QStringList& lines) const;
+    const QStringList& tailLines() const { return tail_; }
+
+    // 任意の1行（読んだページは少数だけキャッシュする）
+    QString lineAt(quint32 line) const;
+    // その行の本文を読めるか（メモリのみの場合、古いページは捨てている）
+    bool hasLine(quint32 line) const;
+
+private:
+    struct ChunkInfo {
+        qint64 offset;
+        quint32 firstLine;
+    };
+
+    void writeChunk(bool endOfPage);
+    bool readCompressedPage(int page, QStringList& lines) const;
+
+    QFile file_;
+    QTextStream out_;
+    mutable QFile reader_;
+    bool compressed_ = false;
+    std::vector<qint64> pageOffsets_;
+    QStringList tail_;
+    quint32 lineCount_ = 0;
+    mutable QCache<int, QStringList> pages_;
+
+    // メモリのみの場合
+    bool inMemory_ = false;
+    bool memoryOpen_ = false;
+    std::deque<QStringList> memoryPages_;   // 書き終えた直近のページ
+    int firstMemoryPage_ = 0;               // memoryPages_ の先頭のページ番号
+
+    // 圧縮時のみ
+    std::vector<ChunkInfo> chunks_;  // チャンクの位置
+    CompressedLog::Deflater deflater_;
+    QByteArray pending_;          // まだ圧縮していない行
+    quint32 pendingLines_ = 0;
+};
+
+#endif // SESSION_LOG_FILE_H
@@ -0,0 +1,113 @@
+#include "event_index.h"
+#include "session_log_file.h"
+#include "session_log_model.h"
+
+namespace {
+
+QString eventTypeLabel(GambleLogType type)
+{
+    switch (type) {
+    case GambleLogType::Payment: return "支払い";
+    case GambleLogType::Gain: return "受け取り";
+    case GambleLogType::Lose: return "外れ";
+    case GambleLogType::Role: break;
+    }
+    return "当たり役";
+}
+
+} // namespace
+
+SessionLogModel::SessionLogModel(const SessionLogFile *logFile, const EventIndex *index, QObject *parent)
+    : QAbstractListModel(parent)
+    , logFile_(logFile)
+    , index_(index)
+{
+}
+
+int SessionLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rowCount_;
+}
+
+QVariant SessionLogModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || !index.isValid() || index.row() >= rowCount_)
+        return QVariant();
+
+    const quint32 line = filtered_ ? filterRows_[index.row()] : static_cast<quint32>(index.row());
+    return lineAt(line);
+}
+
+quint32 SessionLogModel::totalLines() const
+{
+    if (logFile_ && logFile_->isOpen())
+        return logFile_->lineCount();
+    return index_->size();
+}
+
+QString SessionLogModel::lineAt(quint32 line) const
+{
+    if (logFile_ && logFile_->isOpen() && logFile_->hasLine(line))
+        return logFile_->lineAt(line);
+
+    // ファイルを開けなかった場合や、記録しない設定で古い本文を捨てた行は索引の値から組み立てる
+    if (line >= index_->size()) return QString();
+    QString text = formatLogTime(index_->secondsOfDay(line));
+    if (!text.isEmpty())
+        text += " ";
+    text += eventTypeLabel(index_->type(line));
+    if (index_->type(line) == GambleLogType::Payment || index_->type(line) == GambleLogType::Gain)
+        text += QString(" %1円").arg(index_->amount(line));
+    return text;
+}
+
+void SessionLogModel::sync()
+{
+    if (filtered_) return;
+
+    const int total = static_cast<int>(totalLines());
+    if (total <= rowCount_) return;
+
+    beginInsertRows(QModelIndex(), rowCount_, total - 1);
+    rowCount_ = total;
+    endInsertRows();
+}
+
+void SessionLogModel::setFilterRows(std::vector<quint32> rows)
+{
+    beginResetModel();
+    filtered_ = true;
+    filterRows_ = std::move(rows);
+    rowCount_ = static_cast<int>(filterRows_.size());
+    endResetModel();
+}
+
+void SessionLogModel::clearFilter()
+{
+    beginResetModel();
+    filtered_ = false;
+    filterRows_ = std::vector<quint32>();
+    rowCount_ = static_cast<int>(totalLines());
+    endResetModel();
+}
+
+void SessionLogModel::appendFilterRows(const std::vector<quint32> &rows)
+{
+    if (!filtered_ || rows.empty()) return;
+
+    const int count = static_cast<int>(rows.size());
+    beginInsertRows(QModelIndex(), rowCount_, rowCount_ + count - 1);
+    filterRows_.insert(filterRows_.end(), rows.begin(), rows.end());
+    rowCount_ += count;
+    endInsertRows();
+}
+
+void SessionLogModel::removeFirstFilterRows(int count)
+{
+    if (!filtered_ || count <= 0) return;
+
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    filterRows_.erase(filterRows_.begin(), filterRows_.begin() + count);
+    rowCount_ -= count;
+    endRemoveRows();
+}
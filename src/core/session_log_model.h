@@ -0,0 +1,46 @@
+#ifndef SESSION_LOG_MODEL_H
+#define SESSION_LOG_MODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <vector>
+
+class EventIndex;
+class SessionLogFile;
+
+// セッション全体のログを表示するためのモデル
+// ビューが要求した行だけを SessionLogFile からページ単位で読む
+// ログファイルを開けなかった場合や本文を捨てた行は EventIndex の値から行を作る
+class SessionLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    SessionLogModel(const SessionLogFile *logFile, const EventIndex *index, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // イベントが追加されたあとに呼ぶ
+    void sync();
+    // 絞り込み結果の行（イベント番号、昇順）を表示する。clearFilter() で全件表示
+    // 行の追加・削除は begin/end の間で行う（ビューへの通知と中身がずれないように）
+    void setFilterRows(std::vector<quint32> rows);
+    void clearFilter();
+    void appendFilterRows(const std::vector<quint32> &rows);
+    void removeFirstFilterRows(int count);
+    bool isFiltered() const { return filtered_; }
+    const std::vector<quint32> &filterRows() const { return filterRows_; }
+
+private:
+    quint32 totalLines() const;
+    QString lineAt(quint32 line) const;
+
+    const SessionLogFile *logFile_;
+    const EventIndex *index_;
+    bool filtered_ = false;
+    std::vector<quint32> filterRows_;
+    int rowCount_ = 0;
+};
+
+#endif // SESSION_LOG_MODEL_H
@@ -0,0 +1,27 @@
+#ifndef SJIS_TABLE_H
+#define SJIS_TABLE_H
+
+// CP932 (Shift-JIS) 2バイト文字 → UTF-16 変換表
+// 先行バイト 0x81-0x9F, 0xE0-0xFC / 後続バイト 0x40-0x7E, 0x80-0xFC
+constexpr int kSjisLeadCount = 60;
+constexpr int kSjisTrailCount = 188;
+
+extern const char16_t kSjisDoubleByteTable[kSjisLeadCount * kSjisTrailCount];
+
+// 先行バイトなら表の行番号、そうでなければ -1
+constexpr int sjisLeadIndex(unsigned char b)
+{
+    if (b >= 0x81 && b <= 0x9F) return b - 0x81;
+    if (b >= 0xE0 && b <= 0xFC) return b - 0xE0 + 31;
+    return -1;
+}
+
+// 後続バイトなら表の列番号、そうでなければ -1
+constexpr int sjisTrailIndex(unsigned char b)
+{
+    if (b >= 0x40 && b <= 0x7E) return b - 0x40;
+    if (b >= 0x80 && b <= 0xFC) return b - 0x41;
+    return -1;
+}
+
+#endif // SJIS_TABLE_H
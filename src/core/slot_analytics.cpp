@@ -0,0 +1,103 @@
+#include <QRegularExpression>
+#include <QtConcurrent>
+#include <algorithm>
+
+#include "slot_analytics.h"
+
+QString SlotSummary::topRole() const
+{
+    QString best;
+    int bestCount = 0;
+    for (auto it = total.roleCount.cbegin(); it != total.roleCount.cend(); ++it) {
+        if (it.value() > bestCount) {
+            best = it.key();
+            bestCount = it.value();
+        }
+    }
+    return best;
+}
+
+SlotAnalytics::SlotAnalytics(const HistoryRollup *rollup)
+    : rollup_(rollup)
+{
+}
+
+std::vector<SlotSummary> SlotAnalytics::query(const QStringList& patterns, bool grouped,
+                                              const QDateTime& from, const QDateTime& to) const
+{
+    std::vector<SlotSummary> result;
+
+    QList<QRegularExpression> matchers;
+    for (const QString& pattern : patterns) {
+        // 変換結果は全体一致（先頭・末尾に固定）
+        matchers << QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern),
+                                       QRegularExpression::CaseInsensitiveOption);
+    }
+
+    auto matchesAny = [&matchers](const QString& slotName) {
+        if (matchers.isEmpty()) return true;
+        return std::any_of(matchers.cbegin(), matchers.cend(), [&slotName](const QRegularExpression& re) {
+            return re.match(slotName).hasMatch();
+        });
+    };
+
+    QStringList slotNames;
+    for (const QString& slotName : rollup_->slotNames()) {
+        if (matchesAny(slotName))
+            slotNames << slotName;
+    }
+
+    // 日単位の集計を期間分だけ足す（スロットごとに独立なので並列）
+    const QDateTime dayFrom = QDateTime::fromSecsSinceEpoch(
+        HistoryRollup::bucketStart(from.toSecsSinceEpoch(), RollupGranularity::Day));
+    const HistoryRollup *rollup = rollup_;
+    const QList<SlotSummary> perSlot = QtConcurrent::blockingMapped(slotNames, [rollup, &dayFrom, &to](const QString& slotName) {
+        SlotSummary summary;
+        summary.name = slotName;
+        summary.total = rollup->total(slotName, RollupGranularity::Day, dayFrom, to);
+        return summary;
+    });
+
+    if (!grouped || matchers.isEmpty()) {
+        for (const SlotSummary& summary : perSlot) {
+            if (summary.total.spins > 0 || summary.total.spent > 0 || summary.total.gained > 0)
+                result.push_back(summary);
+        }
+        return result;
+    }
+
+    // パターンごとに合算（複数のパターンに一致するスロットはそれぞれに数える）
+    for (int i = 0; i < matchers.size(); ++i) {
+        SlotSummary group;
+        group.name = patterns[i];
+        group.slotCount = 0;
+        for (const SlotSummary& summary : perSlot) {
+            if (!matchers[i].match(summary.name).hasMatch()) continue;
+            group.total.add(summary.total);
+            group.slotCount++;
+        }
+        if (group.slotCount > 0)
+            result.push_back(group);
+    }
+    return result;
+}
+
+QList<QPair<QString, int>> SlotAnalytics::topRoles(const std::vector<SlotSummary>& summaries, int limit)
+{
+    QHash<QString, int> counts;
+    for (const SlotSummary& summary : summaries) {
+        for (auto it = summary.total.roleCount.cbegin(); it != summary.total.roleCount.cend(); ++it)
+            counts[it.key()] += it.value();
+    }
+
+    QList<QPair<QString, int>> result;
+    for (auto it = counts.cbegin(); it != counts.cend(); ++it)
+        result.append({ it.key(), it.value() });
+
+    std::sort(result.begin(), result.end(), [](const QPair<QString, int>& a, const QPair<QString, int>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    if (result.size() > limit)
+        result.resize(limit);
+    return result;
+}
@@ -0,0 +1,41 @@
+#ifndef SLOT_ANALYTICS_H
+#define SLOT_ANALYTICS_H
+
+#include <QDateTime>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include <vector>
+
+#include "history_rollup.h"
+
+// 1スロット（またはワイルドカードでまとめたグループ）の期間集計
+struct SlotSummary {
+    QString name;        // スロット名、またはグループのパターン
+    int slotCount = 1;   // グループに含まれるスロット数
+    RollupBucket total;
+
+    qint64 net() const { return total.gained - total.spent; }
+    double rtp() const { return total.spent > 0 ? total.gained * 100.0 / total.spent : 0.0; }
+    QString topRole() const;
+};
+
+// 記録先フォルダの全スロットを横断する集計
+// 生ファイルは読まず HistoryRollup（共有の索引）から日単位の集計を引く。スロットごとの集計は並列に行う
+class SlotAnalytics {
+public:
+    explicit SlotAnalytics(const HistoryRollup *rollup);
+
+    // patterns はワイルドカード（* ?）。空なら全スロット
+    // grouped ならパターンごとに一致したスロットを合算して1行にする
+    std::vector<SlotSummary> query(const QStringList& patterns, bool grouped,
+                                   const QDateTime& from, const QDateTime& to) const;
+
+    // 全行を通して多く出た役（回数の多い順）
+    static QList<QPair<QString, int>> topRoles(const std::vector<SlotSummary>& summaries, int limit);
+
+private:
+    const HistoryRollup *rollup_;
+};
+
+#endif // SLOT_ANALYTICS_H
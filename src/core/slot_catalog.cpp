@@ -0,0 +1,155 @@
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+
+#include "slot_catalog.h"
+
+namespace {
+
+// カタカナ（ァ〜ヶ）はひらがなに寄せる
+constexpr char16_t kKatakanaFirst = u'ァ';
+constexpr char16_t kKatakanaLast = u'ヶ';
+constexpr char16_t kKanaOffset = 0x60;
+
+} // namespace
+
+bool SlotCatalog::load(const QString& path)
+{
+    clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+    QTextStream in(&file);
+    Category current{ "その他", 0, 0 };
+
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        if (line.startsWith("[") && line.endsWith("]")) {
+            if (current.count > 0)
+                categories_.push_back(current);
+            current.label = line.mid(1, line.length() - 2);
+            current.first = size();
+            current.count = 0;
+        } else {
+            names_.push_back(line);
+            current.count++;
+        }
+    }
+    if (current.count > 0)
+        categories_.push_back(current);
+
+    buildIndex();
+    return true;
+}
+
+void SlotCatalog::clear()
+{
+    names_.clear();
+    keys_.clear();
+    sorted_.clear();
+    categories_.clear();
+    grams_.clear();
+}
+
+QString SlotCatalog::normalize(QStringView text)
+{
+    // NFKC で全角英数→半角、半角カナ→全角（濁点も合成）
+    QString key = text.toString().normalized(QString::NormalizationForm_KC).toCaseFolded();
+    for (QChar& ch : key) {
+        const char16_t c = ch.unicode();
+        if (c >= kKatakanaFirst && c <= kKatakanaLast)
+            ch = QChar(char16_t(c - kKanaOffset));
+    }
+    return key;
+}
+
+bool SlotCatalog::isFileNameSafe(QStringView name)
+{
+    if (name.isEmpty() || name.contains(u"..")) return false;
+
+    // Windows で末尾の '.' と空白は落とされて別の名前になる
+    if (name.endsWith(u'.') || name.endsWith(u' ')) return false;
+
+    for (QChar ch : name) {
+        if (ch.unicode() < 0x20 || ch.unicode() == 0x7f) return false;
+        switch (ch.unicode()) {
+        case u'/': case u'\\': case u':': case u'*': case u'?':
+        case u'"': case u'<': case u'>': case u'|':
+            return false;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+void SlotCatalog::buildIndex()
+{
+    keys_.reserve(names_.size());
+    for (const QString& name : names_)
+        keys_.push_back(normalize(name));
+
+    sorted_.resize(keys_.size());
+    for (quint32 row = 0; row < size(); ++row)
+        sorted_[row] = row;
+    std::sort(sorted_.begin(), sorted_.end(), [this](quint32 a, quint32 b) {
+        return keys_[a] < keys_[b];
+    });
+
+    // 同じ名前で同じ組が複数回出ても1回だけ登録
+    auto add = [this](quint32 key, quint32 row) {
+        std::vector<quint32>& rows = grams_[key];
+        if (rows.empty() || rows.back() != row)
+            rows.push_back(row);
+    };
+    for (quint32 row = 0; row < size(); ++row) {
+        const QString& key = keys_[row];
+        for (qsizetype i = 0; i < key.size(); ++i) {
+            add(gramKey(key[i], QChar()), row);
+            if (i + 1 < key.size())
+                add(gramKey(key[i], key[i + 1]), row);
+        }
+    }
+}
+
+std::vector<quint32> SlotCatalog::search(QStringView text) const
+{
+    std::vector<quint32> result;
+
+    const QString key = normalize(text.trimmed());
+    if (key.isEmpty()) {
+        result.resize(size());
+        for (quint32 row = 0; row < size(); ++row)
+            result[row] = row;
+        return result;
+    }
+
+    // 前方一致はソート済み配列の連続した範囲
+    auto it = std::lower_bound(sorted_.begin(), sorted_.end(), key, [this](quint32 row, const QString& value) {
+        return keys_[row] < value;
+    });
+    for (; it != sorted_.end() && keys_[*it].startsWith(key); ++it)
+        result.push_back(*it);
+    std::sort(result.begin(), result.end());
+
+    // 部分一致は最も件数の少ない組の候補だけを確認する
+    const std::vector<quint32>* candidates = nullptr;
+    const qsizetype gramCount = key.size() == 1 ? 1 : key.size() - 1;
+    for (qsizetype i = 0; i < gramCount; ++i) {
+        const quint32 gram = key.size() == 1 ? gramKey(key[0], QChar()) : gramKey(key[i], key[i + 1]);
+        auto found = grams_.constFind(gram);
+        if (found == grams_.cend()) return result;
+        if (!candidates || found->size() < candidates->size())
+            candidates = &found.value();
+    }
+
+    for (quint32 row : *candidates) {
+        const QString& candidate = keys_[row];
+        if (!candidate.startsWith(key) && candidate.contains(key))
+            result.push_back(row);
+    }
+    return result;
+}
@@ -0,0 +1,49 @@
+#ifndef SLOT_CATALOG_H
+#define SLOT_CATALOG_H
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+#include <vector>
+
+// slotList.txt のスロット一覧と検索用の索引
+// 名前は正規化（全角半角・ひらがなカタカナ・大文字小文字を区別しない）して
+// 前方一致用のソート済み配列と部分一致用の文字・bigram 索引を持つ
+class SlotCatalog {
+public:
+    struct Category {
+        QString label;
+        quint32 first = 0;   // 最初のスロットの番号
+        quint32 count = 0;
+    };
+
+    // "[カテゴリ名]" の行で区切られた一覧を読む（見出しより前は「その他」）
+    bool load(const QString& path);
+    void clear();
+
+    quint32 size() const { return static_cast<quint32>(names_.size()); }
+    const QString& name(quint32 row) const { return names_[row]; }
+    const std::vector<Category>& categories() const { return categories_; }
+
+    // 前方一致を先に、続けて部分一致を一覧の順で返す。空文字列なら全件
+    std::vector<quint32> search(QStringView text) const;
+
+    static QString normalize(QStringView text);
+
+    // ファイル名の先頭に使えるか（区切り文字・予約文字・制御文字・".." を含まない）
+    static bool isFileNameSafe(QStringView name);
+
+private:
+    void buildIndex();
+    static quint32 gramKey(QChar a, QChar b) { return (quint32(a.unicode()) << 16) | b.unicode(); }
+
+    std::vector<QString> names_;
+    std::vector<QString> keys_;          // 正規化した名前
+    std::vector<quint32> sorted_;        // keys_ の辞書順
+    std::vector<Category> categories_;
+
+    // 1文字（後ろは U+0000）と2文字の組 → スロット番号（昇順）
+    QHash<quint32, std::vector<quint32>> grams_;
+};
+
+#endif // SLOT_CATALOG_H
@@ -0,0 +1,99 @@
+#include <QBrush>
+
+#include "slot_catalog.h"
+#include "slot_list_model.h"
+
+namespace {
+
+constexpr int kFetchRows = 256;
+
+} // namespace
+
+SlotListModel::SlotListModel(const SlotCatalog *catalog, QObject *parent)
+    : QAbstractListModel(parent)
+    , catalog_(catalog)
+{
+    reload();
+}
+
+int SlotListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : loaded_;
+}
+
+QVariant SlotListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= loaded_)
+        return QVariant();
+
+    const quint32 row = rows_[index.row()];
+    if (row & kHeaderBit) {
+        if (role == Qt::DisplayRole)
+            return "— " + catalog_->categories()[row & ~kHeaderBit].label + " —";
+        if (role == Qt::ForegroundRole)
+            return QBrush(Qt::gray);
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return catalog_->name(row);
+    return QVariant();
+}
+
+Qt::ItemFlags SlotListModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.row() >= loaded_ || (rows_[index.row()] & kHeaderBit))
+        return Qt::NoItemFlags;   // 見出しは選択不可
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+bool SlotListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && loaded_ < static_cast<int>(rows_.size());
+}
+
+void SlotListModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) return;
+
+    const int count = qMin(kFetchRows, static_cast<int>(rows_.size()) - loaded_);
+    if (count <= 0) return;
+
+    beginInsertRows(QModelIndex(), loaded_, loaded_ + count - 1);
+    loaded_ += count;
+    endInsertRows();
+}
+
+void SlotListModel::reload()
+{
+    filter_.clear();
+
+    std::vector<quint32> rows;
+    for (quint32 i = 0; i < catalog_->categories().size(); ++i) {
+        const SlotCatalog::Category &category = catalog_->categories()[i];
+        rows.push_back(kHeaderBit | i);
+        for (quint32 row = category.first; row < category.first + category.count; ++row)
+            rows.push_back(row);
+    }
+    resetRows(std::move(rows));
+}
+
+void SlotListModel::setFilter(const QString &text)
+{
+    if (text.trimmed().isEmpty()) {
+        if (!filter_.isEmpty())
+            reload();
+        return;
+    }
+
+    filter_ = text;
+    resetRows(catalog_->search(text));
+}
+
+void SlotListModel::resetRows(std::vector<quint32> rows)
+{
+    beginResetModel();
+    rows_ = std::move(rows);
+    loaded_ = qMin(kFetchRows, static_cast<int>(rows_.size()));
+    endResetModel();
+}
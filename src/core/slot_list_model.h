@@ -0,0 +1,41 @@
+#ifndef SLOT_LIST_MODEL_H
+#define SLOT_LIST_MODEL_H
+
+#include <QAbstractListModel>
+#include <vector>
+
+class SlotCatalog;
+
+// スロット選択用のモデル
+// 行はビューがスクロールした分だけ fetchMore で追加する
+// 絞り込みなしではカテゴリ見出し（選択不可）を挟み、絞り込み中は一致したスロットだけを並べる
+class SlotListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit SlotListModel(const SlotCatalog *catalog, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    // 一覧を読み直したあとに呼ぶ
+    void reload();
+    void setFilter(const QString &text);
+    const QString &filter() const { return filter_; }
+
+private:
+    static constexpr quint32 kHeaderBit = 0x80000000u;   // 見出し行（下位ビットはカテゴリ番号）
+
+    void resetRows(std::vector<quint32> rows);
+
+    const SlotCatalog *catalog_;
+    QString filter_;
+    std::vector<quint32> rows_;
+    int loaded_ = 0;
+};
+
+#endif // SLOT_LIST_MODEL_H
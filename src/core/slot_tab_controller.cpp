@@ -1,83 +1,236 @@
-#include <QTextEdit>
+#include <QListView>
 #include <QScrollBar>
+#include <QTimer>
 #include <QMessageBox>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
 
+#include "amount_sum.h"
 #include "slot_tab_controller.h"
 #include "log_watcher.h"
+#include "session_log_model.h"
 
 SlotTabController::SlotTabController(LogWatcher* watcher,
                                     InfoWidget* infoWidget,
-                                    QTextEdit* logTextEdit,
+                                    QListView* logView,
                                     bool enableSave, 
-                                    QFile* logFile, 
+                                    const QString& logFilePath, 
                                     QObject* parent)
 
     : QObject(parent)
+    , roles_(&watcher->roles())
     , infoWidget_(infoWidget)
-    , logTextEdit_(logTextEdit)
+    , logView_(logView)
     , enableSave_(enableSave)
-    , logFile_(logFile)
 {
-    connect(watcher, &LogWatcher::newLogLine, this, &SlotTabController::handleNewLogLine);
+    // 記録しない場合はファイルに書かず、直近の本文だけをメモリに持つ
+    logFile_ = std::make_unique<SessionLogFile>(enableSave_ ? logFilePath : QString());
+
+    logModel_ = new SessionLogModel(logFile_.get(), &index_, this);
+    logView_->setModel(logModel_);
+
+    connect(watcher, &LogWatcher::newLogBatch, this, &SlotTabController::handleNewLogBatch);
+
+    // 圧縮時は新しい行が来なくても一定間隔でファイルに出す
+    if (logFile_->isCompressed()) {
+        auto* checkpointTimer = new QTimer(this);
+        connect(checkpointTimer, &QTimer::timeout, this, [this]() {
+            if (logFileOpened_)
+                logFile_->checkpoint();
+        });
+        checkpointTimer->start(SessionLogFile::kCheckpointIntervalMs);
+    }
 }
 
-void SlotTabController::handleNewLogLine(const GambleLog& log)
+SlotTabController::~SlotTabController()
 {
-    // 表示用テキスト構築
-    QString text;
-    if (!log.time.isEmpty())
-        text += log.time + " ";
-        
-    text += log.content;
-    
-    logLines_ << log.content;
-    while (logLines_.size() > maxLogLines_) {
-        logLines_.removeFirst();
-    }
-    
-    logTextEdit_->setPlainText(logLines_.join("\n"));
-    QScrollBar* scrollBar = logTextEdit_->verticalScrollBar();
-    scrollBar->setValue(scrollBar->maximum());
+    // ビューより先にモデルが消えるので外しておく
+    if (logView_ && logView_->model() == logModel_)
+        logView_->setModel(nullptr);
+}
 
+void SlotTabController::handleNewLogBatch(const GambleLogBatch& batch)
+{
     // ログ保存（初回のみ open）
-    if (enableSave_ && logFile_) {
-        if (!logFileOpened_) {
-            if (!logFile_->open(QIODevice::Append | QIODevice::Text)) {
+    if (logFile_ && !logFileOpened_) {
+        if (!logFile_->open()) {
+            if (enableSave_)
                 QMessageBox::warning(nullptr, "警告", "ログファイルを開けません。記録できません。");
-                enableSave_ = false;
-                logFile_ = nullptr;
-            } else {
-                logFileOpened_ = true;
-            }
+            enableSave_ = false;
+            logFile_.reset();
+            logModel_->deleteLater();
+            logModel_ = new SessionLogModel(nullptr, &index_, this);
+            if (filterActive_)
+                logModel_->setFilterRows({});   // 絞り込み中なら新しいモデルでも続ける（最初のバッチなのでまだ行はない）
+            logView_->setModel(logModel_);
+        } else {
+            logFileOpened_ = true;
         }
+    }
+
+    changedRoles_.clear();
+    const bool followTail = isViewAtBottom();
+    newFilterRows_.clear();
+
+    for (const GambleLog& log : batch.logs) {
+        QStringView content = batch.content(log);
 
         if (logFileOpened_) {
-            QTextStream out(logFile_);
-            out << text << "\n";
-            logFile_->flush();
+            // 保存用テキスト構築
+            QString text;
+            if (log.secondsOfDay != kNoLogTime)
+                text += formatLogTime(log.secondsOfDay) + " ";
+            text += content;
+            logFile_->appendLine(text);
         }
-    }
 
-    switch (log.type) {
-    case GambleLogType::Payment:
-        totalSpent_ += log.amount;
-        spinCount_++;
-        break;
-    case GambleLogType::Gain:
-        totalGained_ += log.amount;
-        break;
-    case GambleLogType::Role:
-        roleCount_[log.roleName]++;
-        break;
+        SpinRecord spin;
+        const bool spinFinished = correlator_.feed(log, spin);
+        if (spinFinished)
+            recordSpin(spin);
+
+        // 受け取りの行は回転の役で引けるようにする
+        quint32 indexRole = log.roleId;
+        if (log.type == GambleLogType::Gain && spinFinished)
+            indexRole = spin.roleId;
+
+        const quint32 row = index_.append(log.type, log.secondsOfDay, log.amount, indexRole);
+        if (filterActive_ && index_.matches(row, filter_, [content](quint32) { return content.toString(); }))
+            newFilterRows_.push_back(row);
+
+        switch (log.type) {
+        case GambleLogType::Payment:
+            addToTotal(totalSpent_, log.amount);
+            spinCount_++;
+            break;
+        case GambleLogType::Gain:
+            addToTotal(totalGained_, log.amount);
+            break;
+        case GambleLogType::Role:
+            ensureRole(log.roleId);
+            roleCount_[log.roleId]++;
+            if (!changedRoles_.contains(log.roleId))
+                changedRoles_.append(log.roleId);
+            break;
+        default:
+            break;
+        }
     }
 
-    // infoWidget に統計更新
+    if (logFileOpened_)
+        logFile_->flush();
+
+    // 表示は行数を伝えるだけ。実際の行はビューが必要な分だけ読む
+    if (filterActive_) {
+        logModel_->appendFilterRows(newFilterRows_);
+        dropExpiredFilterRows();
+    } else
+        logModel_->sync();
+    if (followTail)
+        logView_->scrollToBottom();
+
+    // infoWidget に統計更新（バッチごとに1回）
     infoWidget_->setStats(totalSpent_, totalGained_, spinCount_);
-    infoWidget_->updateRoleTable(roleCount_);
+    infoWidget_->updateRoleTable(roleCountMap());
+
+    emit statsChanged(totalSpent_, totalGained_, spinCount_);
+    for (quint32 roleId : std::as_const(changedRoles_))
+        emit roleCountChanged(roles_->name(roleId), roleCount_[roleId]);
+}
+
+void SlotTabController::setFilter(const EventQuery& query)
+{
+    filter_ = query;
+    filterActive_ = !query.isEmpty();
+
+    if (filterActive_)
+        logModel_->setFilterRows(index_.search(filter_, std::numeric_limits<size_t>::max(),
+                                               [this](quint32 row) { return contentAt(row); }));
+    else
+        logModel_->clearFilter();
+    logView_->scrollToBottom();
+}
+
+void SlotTabController::dropExpiredFilterRows()
+{
+    // 「直近 N 分」は最新の行に合わせて窓が進むので、外れた古い行を先頭から落とす
+    if (filter_.recentSeconds < 0) return;
+
+    const qint64 from = index_.fromTime(filter_);
+    const std::vector<quint32>& rows = logModel_->filterRows();
+    auto keep = std::lower_bound(rows.begin(), rows.end(), from,
+                                 [this](quint32 row, qint64 time) { return index_.time(row) < time; });
+    logModel_->removeFirstFilterRows(static_cast<int>(keep - rows.begin()));
+}
+
+QString SlotTabController::contentAt(quint32 row) const
+{
+    if (!logFileOpened_) return QString();
+
+    // 保存した行は "[HH:MM:SS] 本文"
+    QString line = logFile_->lineAt(row);
+    const qint32 secondsOfDay = index_.secondsOfDay(row);
+    if (secondsOfDay != kNoLogTime)
+        line.remove(0, formatLogTime(secondsOfDay).size() + 1);
+    return line;
+}
+
+bool SlotTabController::isViewAtBottom() const
+{
+    const QScrollBar* scrollBar = logView_->verticalScrollBar();
+    return scrollBar->value() >= scrollBar->maximum();
+}
+
+void SlotTabController::ensureRole(quint32 roleId)
+{
+    if (static_cast<int>(roleId) >= roleCount_.size()) {
+        roleCount_.resize(roleId + 1);
+        rolePayout_.resize(roleId + 1);
+    }
+}
+
+void SlotTabController::recordSpin(const SpinRecord& spin)
+{
+    if (spin.roleId != kNoRole) {
+        ensureRole(spin.roleId);
+        addToTotal(rolePayout_[spin.roleId], spin.payout);
+    }
+
+    if (spin.startSecondsOfDay != kNoLogTime) {
+        totalSpinSeconds_ += spin.durationSeconds;
+        timedSpinCount_++;
+        maxSpinSeconds_ = qMax(maxSpinSeconds_, spin.durationSeconds);
+    }
+}
+
+void SlotTabController::addToTotal(qint64& total, qint64 amount)
+{
+    if (addAmount(total, amount) || amountOverflowed_) return;
+
+    amountOverflowed_ = true;
+    qWarning() << "金額の合計が上限を超えました。以降の合計は上限で止まります";
+}
+
+void SlotTabController::finishSession()
+{
+    SpinRecord spin;
+    if (correlator_.flush(spin))
+        recordSpin(spin);
+}
+
+QMap<QString, int> SlotTabController::roleCountMap() const
+{
+    QMap<QString, int> result;
+    for (int id = 0; id < roleCount_.size(); ++id) {
+        if (roleCount_[id] > 0)
+            result.insert(roles_->name(id), roleCount_[id]);
+    }
+    return result;
 }
 
 bool SlotTabController::hasLogs() const {
-    return !logLines_.isEmpty();
+    return index_.size() > 0;
 }
 
 QString SlotTabController::toPlainText() const {
@@ -89,12 +242,14 @@ QString SlotTabController::toPlainText() const {
 
     text += "\n役情報:\n";
 
+    const QMap<QString, int> roleCount = roleCountMap();
+
     int totalRole = 0;
-    for (const auto count : roleCount_.values())
+    for (const auto count : roleCount.values())
         totalRole += count;
 
-    for (const auto& role : roleCount_.keys()) {
-        int count = roleCount_[role];
+    for (const auto& role : roleCount.keys()) {
+        int count = roleCount[role];
         double rate = (totalRole > 0) ? count * 100.0 / totalRole : 0.0;
         text += QString("%1: %2回 (%3%)\n")
             .arg(role)
@@ -102,5 +257,20 @@ QString SlotTabController::toPlainText() const {
             .arg(QString::number(rate, 'f', 2));
     }
 
+    text += "\n役別配当:\n";
+    for (int id = 0; id < roleCount_.size(); ++id) {
+        if (roleCount_[id] == 0) continue;
+        text += QString("%1: %2円 (平均 %3円)\n")
+            .arg(roles_->name(id))
+            .arg(rolePayout_[id])
+            .arg(rolePayout_[id] / roleCount_[id]);
+    }
+
+    if (timedSpinCount_ > 0) {
+        text += QString("\n平均回転時間: %1秒\n")
+            .arg(QString::number(double(totalSpinSeconds_) / timedSpinCount_, 'f', 2));
+        text += QString("最長回転時間: %1秒\n").arg(maxSpinSeconds_);
+    }
+
     return text;
 }
\ No newline at end of file
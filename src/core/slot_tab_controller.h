@@ -3,13 +3,18 @@
 
 #include <QObject>
 #include <QMap>
-#include <QFile>
+#include <QVector>
+#include <memory>
 
+#include "event_index.h"
 #include "infowidget.h"
 #include "log_parser.h"
+#include "session_log_file.h"
+#include "spin_correlator.h"
 
-class QTextEdit;
+class QListView;
 class LogWatcher;
+class SessionLogModel;
 
 class SlotTabController : public QObject
 {
@@ -18,32 +23,65 @@ class SlotTabController : public QObject
 public:
     SlotTabController(LogWatcher *watcher, 
         InfoWidget *infoWidget, 
-        QTextEdit *logTextEdit, 
+        QListView *logView, 
         bool enableSave, 
-        QFile *logFile, 
+        const QString &logFilePath, 
         QObject *parent = nullptr);
+    ~SlotTabController();
     void clearLogLine();
     bool hasLogs() const;
+    void finishSession();  // 途中の回転を確定させる
     QString toPlainText() const;
 
+    // ログ表示の絞り込み（空の条件で解除）
+    void setFilter(const EventQuery& query);
+    const EventIndex& index() const { return index_; }
+    const RoleTable& roles() const { return *roles_; }
+
+signals:
+    // バッチを集計するたびに通知（オーバーレイ配信用）
+    void statsChanged(qint64 spent, qint64 gained, int spins);
+    void roleCountChanged(const QString& role, int count);
+
 private slots:
-    void handleNewLogLine(const GambleLog& log);
+    void handleNewLogBatch(const GambleLogBatch& batch);
 
 private:
+    QMap<QString, int> roleCountMap() const;
+    void ensureRole(quint32 roleId);
+    void recordSpin(const SpinRecord& spin);
+    bool isViewAtBottom() const;
+    QString contentAt(quint32 row) const;   // 行の本文（セッションログから読む）
+    void dropExpiredFilterRows();           // 直近 N 分の窓から外れた絞り込み行を落とす
+    void addToTotal(qint64& total, qint64 amount);
+
+    const RoleTable *roles_;
     InfoWidget *infoWidget_;
-    QTextEdit *logTextEdit_;
+    QListView *logView_;
     bool enableSave_;
-    QFile *logFile_;
+    std::unique_ptr<SessionLogFile> logFile_;
     
     bool logFileOpened_ = false;
-    QStringList logLines_;
-    const int maxLogLines_ = 500; 
+
+    EventIndex index_;
+    SessionLogModel *logModel_;
+    EventQuery filter_;
+    bool filterActive_ = false;
+    std::vector<quint32> newFilterRows_;  // バッチ内で絞り込み条件に合った行（モデルへ渡す）
     
-    int totalSpent_ = 0;
-    int totalGained_ = 0;
+    qint64 totalSpent_ = 0;
+    qint64 totalGained_ = 0;
     int spinCount_ = 0;
+    bool amountOverflowed_ = false;  // 警告は1回だけ
+
+    QVector<int> roleCount_;  // 役 ID → 出現回数
+    QVector<qint64> rolePayout_;  // 役 ID → 受取額合計
+    QVector<quint32> changedRoles_;  // バッチ内で回数が変わった役
 
-    QMap<QString, int> roleCount_;  // 役名 → 出現回数
+    SpinCorrelator correlator_;
+    qint64 totalSpinSeconds_ = 0;  // 回転ごとの所要時間の合計
+    int timedSpinCount_ = 0;
+    int maxSpinSeconds_ = 0;
 };
 
 #endif // SLOT_TAB_CONTROLLER_H
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "amount_sum.h"
+#include "spin_correlator.h"
+
+namespace {
+
+constexpr qint32 kSecondsPerDay = 24 * 60 * 60;
+
+} // namespace
+
+void SpinCorrelator::begin(const GambleLog& log)
+{
+    current_ = SpinRecord();
+    current_.startSecondsOfDay = log.secondsOfDay;
+    lastSecondsOfDay_ = log.secondsOfDay;
+}
+
+void SpinCorrelator::finish(SpinRecord& record)
+{
+    if (current_.startSecondsOfDay != kNoLogTime && lastSecondsOfDay_ != kNoLogTime) {
+        // 日付をまたいだ場合も考慮
+        current_.durationSeconds = (lastSecondsOfDay_ - current_.startSecondsOfDay + kSecondsPerDay) % kSecondsPerDay;
+    }
+    record = current_;
+    state_ = State::Idle;
+}
+
+bool SpinCorrelator::feed(const GambleLog& log, SpinRecord& record)
+{
+    bool finished = false;
+
+    switch (log.type) {
+    case GambleLogType::Payment:
+        // 受け取りのない回転は次の支払いで確定
+        if (state_ != State::Idle) {
+            finish(record);
+            finished = true;
+        }
+        begin(log);
+        current_.bet = log.amount;
+        state_ = State::Paid;
+        break;
+
+    case GambleLogType::Lose:
+    case GambleLogType::Role:
+        if (state_ == State::Resolved) {
+            finish(record);
+            finished = true;
+        }
+        if (state_ == State::Idle)
+            begin(log);  // 支払いを見逃した回転
+        current_.roleId = (log.type == GambleLogType::Role) ? log.roleId : kNoRole;
+        lastSecondsOfDay_ = log.secondsOfDay;
+        state_ = State::Resolved;
+        break;
+
+    case GambleLogType::Gain:
+        if (state_ == State::Idle)
+            begin(log);
+        addAmount(current_.payout, log.amount);
+        lastSecondsOfDay_ = log.secondsOfDay;
+        finish(record);
+        finished = true;
+        break;
+    }
+
+    return finished;
+}
+
+bool SpinCorrelator::flush(SpinRecord& record)
+{
+    if (state_ == State::Idle) return false;
+    finish(record);
+    return true;
+}
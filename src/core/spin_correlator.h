@@ -0,0 +1,38 @@
+#ifndef SPIN_CORRELATOR_H
+#define SPIN_CORRELATOR_H
+
+#include "log_parser.h"
+
+// 1回転分の記録（支払い → 外れ or 役 → 受け取り）
+struct SpinRecord {
+    qint64 bet = 0;                     // 支払額（支払いを見逃した場合は 0）
+    quint32 roleId = kNoRole;           // 当たり役（外れ・不明なら kNoRole）
+    qint64 payout = 0;                  // 受取額
+    qint32 startSecondsOfDay = kNoLogTime;
+    qint32 durationSeconds = 0;         // 最初の行から最後の行まで
+};
+
+// イベント列を回転単位にまとめるストリーミング処理。保持する状態は1回転分のみ
+class SpinCorrelator {
+public:
+    // イベントを1つ与える。回転が確定したら record に書いて true を返す
+    bool feed(const GambleLog& log, SpinRecord& record);
+    // 途中の回転を確定させる（セッション終了時）
+    bool flush(SpinRecord& record);
+
+private:
+    enum class State {
+        Idle,       // 回転なし
+        Paid,       // 支払い済み、結果待ち
+        Resolved    // 外れ or 役が確定、受け取り待ち
+    };
+
+    void begin(const GambleLog& log);
+    void finish(SpinRecord& record);
+
+    State state_ = State::Idle;
+    SpinRecord current_;
+    qint32 lastSecondsOfDay_ = kNoLogTime;
+};
+
+#endif // SPIN_CORRELATOR_H
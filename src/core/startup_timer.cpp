@@ -0,0 +1,31 @@
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+#include "startup_timer.h"
+
+namespace {
+
+QElapsedTimer& timer()
+{
+    static QElapsedTimer instance;
+    return instance;
+}
+
+qint64 lastMark = 0;
+
+} // namespace
+
+void StartupTimer::start()
+{
+    if (!timer().isValid())
+        timer().start();
+}
+
+void StartupTimer::mark(const char* phase)
+{
+    start();
+    const qint64 now = timer().elapsed();
+    qInfo("startup: %-24s %5lld ms (+%lld ms)", phase, static_cast<long long>(now),
+          static_cast<long long>(now - lastMark));
+    lastMark = now;
+}
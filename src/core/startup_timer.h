@@ -0,0 +1,12 @@
+#ifndef STARTUP_TIMER_H
+#define STARTUP_TIMER_H
+
+// 起動時の各段階の経過時間をログに出す（最初の呼び出しを 0 ms とする）
+namespace StartupTimer {
+
+void start();
+void mark(const char* phase);
+
+} // namespace StartupTimer
+
+#endif // STARTUP_TIMER_H
@@ -0,0 +1,94 @@
+#include <cstring>
+
+#include "tail_reader.h"
+
+TailReader::TailReader(qsizetype bufferSize)
+{
+    buffer_.resize(bufferSize);
+}
+
+bool TailReader::open(const QString& path)
+{
+    close();
+
+    // Qt 側のバッファを通さず、自前のバッファへ直接読む
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) return false;
+
+    resetBuffer();
+    filePos_ = 0;
+    return true;
+}
+
+void TailReader::close()
+{
+    if (file_.isOpen()) file_.close();
+    resetBuffer();
+    filePos_ = 0;
+}
+
+void TailReader::seekToEnd()
+{
+    if (!file_.isOpen()) return;
+
+    resetBuffer();
+    filePos_ = file_.size();
+    file_.seek(filePos_);
+}
+
+bool TailReader::isTruncated() const
+{
+    return file_.isOpen() && file_.size() < filePos_;
+}
+
+void TailReader::resetBuffer()
+{
+    begin_ = 0;
+    scan_ = 0;
+    end_ = 0;
+}
+
+bool TailReader::fill()
+{
+    // 未処理の行の断片をバッファ先頭へ寄せる
+    if (begin_ > 0) {
+        std::memmove(buffer_.data(), buffer_.constData() + begin_, end_ - begin_);
+        end_ -= begin_;
+        scan_ -= begin_;
+        begin_ = 0;
+    }
+
+    // バッファより長い行のときだけ拡張する
+    if (end_ == buffer_.size())
+        buffer_.resize(buffer_.size() * 2);
+
+    const qint64 n = file_.read(buffer_.data() + end_, buffer_.size() - end_);
+    if (n <= 0) return false;
+
+    end_ += n;
+    filePos_ += n;
+    return true;
+}
+
+bool TailReader::nextLine(QByteArrayView& line)
+{
+    if (!file_.isOpen()) return false;
+
+    while (true) {
+        const char* data = buffer_.constData();
+        const void* newline = std::memchr(data + scan_, '\n', end_ - scan_);
+        if (newline) {
+            const qsizetype lineEnd = static_cast<const char*>(newline) - data;
+            qsizetype length = lineEnd - begin_;
+            if (length > 0 && data[begin_ + length - 1] == '\r')
+                --length;
+
+            line = QByteArrayView(data + begin_, length);
+            begin_ = scan_ = lineEnd + 1;
+            return true;
+        }
+
+        scan_ = end_;
+        if (!fill()) return false;
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef TAIL_READER_H
+#define TAIL_READER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+
+// 追記されるファイルを末尾から行単位で読む
+// 固定サイズのバッファを使い回し、行はバッファ内のビューとして返す（コピーしない）
+// 改行で終わっていない行は次の追記まで保留する
+class TailReader {
+public:
+    explicit TailReader(qsizetype bufferSize = 64 * 1024);
+
+    bool open(const QString& path);   // 先頭から読む
+    void close();
+    bool isOpen() const { return file_.isOpen(); }
+
+    void seekToEnd();                 // 現在の末尾まで読み飛ばす
+    bool isTruncated() const;         // ローテーション等でファイルが縮んだか
+
+    // 次の完結した行を返す。line は次の呼び出しまで有効。行末の \r\n は含まない
+    bool nextLine(QByteArrayView& line);
+
+private:
+    bool fill();
+    void resetBuffer();
+
+    QFile file_;
+    QByteArray buffer_;
+    qsizetype begin_ = 0;   // 未処理データの先頭
+    qsizetype scan_ = 0;    // 改行を探し終えた位置
+    qsizetype end_ = 0;     // 読み込み済みデータの末尾
+    qint64 filePos_ = 0;    // buffer_[end_] に対応するファイル位置
+};
+
+#endif // TAIL_READER_H
@@ -0,0 +1,264 @@
+#include <QtAlgorithms>
+
+#include "sjis_table.h"
+#include "text_decoder.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GAMBLELIVE_HAVE_SSE2 1
+#endif
+
+namespace {
+
+constexpr char16_t kReplacement = 0xFFFD;
+
+// 先頭から続く ASCII を dst へ展開し、処理したバイト数を返す
+qsizetype copyAsciiRun(const unsigned char* src, qsizetype size, char16_t* dst)
+{
+    qsizetype i = 0;
+#ifdef GAMBLELIVE_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        int mask = _mm_movemask_epi8(bytes);
+        if (mask != 0) {
+            const qsizetype n = qCountTrailingZeroBits(static_cast<quint32>(mask));
+            for (qsizetype j = 0; j < n; ++j)
+                dst[i + j] = src[i + j];
+            return i + n;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+    }
+#endif
+    for (; i < size && src[i] < 0x80; ++i)
+        dst[i] = src[i];
+    return i;
+}
+
+char16_t decodeSjisPair(unsigned char lead, unsigned char trail)
+{
+    int row = sjisLeadIndex(lead);
+    int col = sjisTrailIndex(trail);
+    if (row < 0 || col < 0) return kReplacement;
+    return kSjisDoubleByteTable[row * kSjisTrailCount + col];
+}
+
+// Shift-JIS → UTF-16。末尾で切れた先行バイトは pendingLead に残す
+qsizetype decodeShiftJis(const unsigned char* src, qsizetype size, char16_t* dst,
+                         unsigned char* pending, int& pendingSize)
+{
+    char16_t* out = dst;
+    qsizetype i = 0;
+
+    if (pendingSize > 0 && size > 0) {
+        if (sjisTrailIndex(src[0]) >= 0) {
+            *out++ = decodeSjisPair(pending[0], src[0]);
+            i = 1;
+        } else {
+            *out++ = kReplacement;
+        }
+        pendingSize = 0;
+    }
+
+    while (i < size) {
+        qsizetype run = copyAsciiRun(src + i, size - i, out);
+        i += run;
+        out += run;
+        if (i >= size) break;
+
+        unsigned char b = src[i];
+        if (b >= 0xA1 && b <= 0xDF) {
+            // 半角カナ
+            *out++ = static_cast<char16_t>(0xFF61 + (b - 0xA1));
+            ++i;
+        } else if (sjisLeadIndex(b) >= 0) {
+            if (i + 1 >= size) {
+                pending[0] = b;
+                pendingSize = 1;
+                ++i;
+                break;
+            }
+            unsigned char trail = src[i + 1];
+            if (sjisTrailIndex(trail) < 0) {
+                // 不正な後続バイトは置換文字にして後続バイト側から再開
+                *out++ = kReplacement;
+                ++i;
+            } else {
+                *out++ = decodeSjisPair(b, trail);
+                i += 2;
+            }
+        } else {
+            *out++ = kReplacement;
+            ++i;
+        }
+    }
+    return out - dst;
+}
+
+int utf8SequenceLength(unsigned char lead)
+{
+    if (lead >= 0xC2 && lead <= 0xDF) return 2;
+    if (lead >= 0xE0 && lead <= 0xEF) return 3;
+    if (lead >= 0xF0 && lead <= 0xF4) return 4;
+    return 0;
+}
+
+// 1文字分をデコード。成功時は消費バイト数、不正なら 0
+inline bool isUtf8Continuation(unsigned char byte)
+{
+    return (byte & 0xC0) == 0x80;
+}
+
+int decodeUtf8Sequence(const unsigned char* s, int len, char32_t& cp)
+{
+    unsigned char lead = s[0];
+    if (len == 2) {
+        if ((s[1] & 0xC0) != 0x80) return 0;
+        cp = ((lead & 0x1F) << 6) | (s[1] & 0x3F);
+        return 2;
+    }
+    if (len == 3) {
+        if ((s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80) return 0;
+        cp = ((lead & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+        if (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+        return 3;
+    }
+    if ((s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80 || (s[3] & 0xC0) != 0x80) return 0;
+    cp = ((lead & 0x07) << 18) | ((s[1] & 0x3F) << 12) | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+    if (cp < 0x10000 || cp > 0x10FFFF) return 0;
+    return 4;
+}
+
+char16_t* writeCodePoint(char32_t cp, char16_t* out)
+{
+    if (cp < 0x10000) {
+        *out++ = static_cast<char16_t>(cp);
+    } else {
+        cp -= 0x10000;
+        *out++ = static_cast<char16_t>(0xD800 + (cp >> 10));
+        *out++ = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+    }
+    return out;
+}
+
+// UTF-8 → UTF-16。末尾で切れたシーケンスは pending に残す
+qsizetype decodeUtf8(const unsigned char* src, qsizetype size, char16_t* dst,
+                     unsigned char* pending, int& pendingSize)
+{
+    char16_t* out = dst;
+    qsizetype i = 0;
+
+    // 前回から持ち越したシーケンスを先に完成させる
+    // 続きのバイト（10xxxxxx）以外が来たら U+FFFD を出し、そのバイトは先頭から処理し直す
+    if (pendingSize > 0) {
+        int need = utf8SequenceLength(pending[0]);
+        while (pendingSize < need && i < size && isUtf8Continuation(src[i]))
+            pending[pendingSize++] = src[i++];
+        if (pendingSize < need && i >= size) return 0;
+
+        char32_t cp = 0;
+        if (pendingSize == need && decodeUtf8Sequence(pending, need, cp) == need) {
+            out = writeCodePoint(cp, out);
+        } else {
+            *out++ = kReplacement;
+        }
+        pendingSize = 0;
+    }
+
+    while (i < size) {
+        qsizetype run = copyAsciiRun(src + i, size - i, out);
+        i += run;
+        out += run;
+        if (i >= size) break;
+
+        int len = utf8SequenceLength(src[i]);
+        if (len == 0) {
+            *out++ = kReplacement;
+            ++i;
+            continue;
+        }
+        if (i + len > size) {
+            // 持ち越すのは続きのバイトだけで終わっている場合のみ
+            qsizetype end = i + 1;
+            while (end < size && isUtf8Continuation(src[end]))
+                ++end;
+            if (end < size) {
+                *out++ = kReplacement;
+                i = end;
+                continue;
+            }
+            pendingSize = 0;
+            while (i < size)
+                pending[pendingSize++] = src[i++];
+            break;
+        }
+
+        char32_t cp = 0;
+        if (decodeUtf8Sequence(src + i, len, cp) == len) {
+            out = writeCodePoint(cp, out);
+            i += len;
+        } else {
+            // 不正なシーケンスは先行バイトと続きのバイトをまとめて置換文字1つにする
+            // （持ち越しを経由した場合と同じ結果になるように）
+            *out++ = kReplacement;
+            ++i;
+            for (int k = 1; k < len && isUtf8Continuation(src[i]); ++k)
+                ++i;
+        }
+    }
+    return out - dst;
+}
+
+TextDecoder::Encoding encodingFromName(const QString& name)
+{
+    const QString key = name.trimmed().toLower().remove('-').remove('_');
+    if (key == "shiftjis" || key == "sjis" || key == "cp932" || key == "ms932"
+        || key == "windows31j" || key == "mskanji")
+        return TextDecoder::Encoding::ShiftJis;
+    if (key == "utf8" || key.isEmpty())
+        return TextDecoder::Encoding::Utf8;
+    return TextDecoder::Encoding::Other;
+}
+
+} // namespace
+
+TextDecoder::TextDecoder(const QString& encodingName)
+    : encoding_(encodingFromName(encodingName))
+{
+    if (encoding_ == Encoding::Other) {
+        // ICU 有効な Qt ならその他のエンコーディングも扱える。無ければ UTF-8 とみなす
+        fallback_ = QStringDecoder(encodingName.toUtf8().constData());
+        if (!fallback_.isValid())
+            encoding_ = Encoding::Utf8;
+    }
+}
+
+void TextDecoder::decode(const char* data, qsizetype size, QString& out)
+{
+    if (size <= 0) return;
+
+    if (encoding_ == Encoding::Other) {
+        out += QString(fallback_.decode(QByteArrayView(data, size)));
+        return;
+    }
+
+    // 1バイトから最大1コードユニット（UTF-8 の4バイト→サロゲート2つ）なので size + 持ち越し分で足りる
+    const qsizetype oldSize = out.size();
+    out.resize(oldSize + size + pendingSize_ + 1);
+    char16_t* dst = reinterpret_cast<char16_t*>(out.data()) + oldSize;
+    const auto* src = reinterpret_cast<const unsigned char*>(data);
+
+    qsizetype written = (encoding_ == Encoding::ShiftJis)
+        ? decodeShiftJis(src, size, dst, pending_, pendingSize_)
+        : decodeUtf8(src, size, dst, pending_, pendingSize_);
+
+    out.resize(oldSize + written);
+}
+
+void TextDecoder::reset()
+{
+    pendingSize_ = 0;
+    if (encoding_ == Encoding::Other)
+        fallback_.resetState();
+}
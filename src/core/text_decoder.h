@@ -0,0 +1,32 @@
+#ifndef TEXT_DECODER_H
+#define TEXT_DECODER_H
+
+#include <QString>
+#include <QStringDecoder>
+
+// ログのバイト列を UTF-16 に変換するインクリメンタルデコーダ
+// Shift-JIS (CP932) と UTF-8 は内蔵の変換表で処理し、それ以外は QStringDecoder に任せる
+class TextDecoder {
+public:
+    enum class Encoding {
+        ShiftJis,
+        Utf8,
+        Other
+    };
+
+    explicit TextDecoder(const QString& encodingName);
+
+    // data を変換して out の末尾に追加する。途中で切れたマルチバイト文字は次回に持ち越す
+    void decode(const char* data, qsizetype size, QString& out);
+    void reset();
+
+    Encoding encoding() const { return encoding_; }
+
+private:
+    Encoding encoding_;
+    unsigned char pending_[4] = {};  // 持ち越し中のバイト
+    int pendingSize_ = 0;
+    QStringDecoder fallback_;
+};
+
+#endif // TEXT_DECODER_H
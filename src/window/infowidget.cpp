@@ -20,7 +20,7 @@ InfoWidget::~InfoWidget()
     delete ui;
 }
 
-void InfoWidget::setStats(int spent, int gained, int spins) {
+void InfoWidget::setStats(qint64 spent, qint64 gained, int spins) {
     QLocale locale = QLocale::system();
 
     ui->labelSpent->setText(QString("-%1").arg(locale.toString(spent)));
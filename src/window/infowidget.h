@@ -15,7 +15,7 @@ public:
     explicit InfoWidget(QWidget *parent = nullptr);
     ~InfoWidget();
     
-    void setStats(int spent, int gained, int spins);
+    void setStats(qint64 spent, qint64 gained, int spins);
     void updateRoleTable(const QMap<QString, int>& roleCount);
     void setSlotName(const QString& slotName);
     void clearStats();
@@ -1,64 +1,86 @@
+#include <QCompleter>
 #include <QFileDialog>
 #include <QFile>
 #include <QMessageBox>
 #include <QStandardPaths>
-#include <QStandardItem>
-#include <QStandardItemModel>
 #include <QHBoxLayout>
 #include <QDesktopServices>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QHeaderView>
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "infowidget.h"
 #include "config_manager.h"
+#include "slot_analytics.h"
+#include "startup_timer.h"
+
+namespace {
+
+// 並べ替えは表示した文字列ではなく値で行う
+class NumericItem : public QTableWidgetItem {
+public:
+    NumericItem(const QString& text, double value) : QTableWidgetItem(text) { setData(Qt::UserRole, value); }
+    bool operator<(const QTableWidgetItem& other) const override {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
+    StartupTimer::mark("ui setup");
 
-    // ログディレクトリ未設定ならデフォルトを作成
+    // ログディレクトリ未設定ならデフォルトを設定（作成は記録開始時に行う）
     QString existing = ConfigManager::instance().get("LogDirectory").toString();
     if (existing.isEmpty()) {
         QString defaultDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/slotLogs";
-        QDir dir(defaultDir);
-
-        if (!dir.exists()) {
-            if (!dir.mkpath(".")) {
-                QMessageBox::warning(this, "警告", "ログディレクトリの作成に失敗しました。");
-            }
-        }
-
-        QString absPath = dir.absolutePath();
-        ConfigManager::instance().set("LogDirectory", absPath);
-        ConfigManager::instance().save();
+        ConfigManager::instance().set("LogDirectory", QDir(defaultDir).absolutePath());
+        ConfigManager::instance().saveLater();
     }
 
-    
+    ui->slotComboBox->setEditable(true);
+    ui->slotComboBox->setInsertPolicy(QComboBox::NoInsert);
+
     // スロットタブ
     infoSlot_ = new InfoWidget(this);
     ui->mainLayout->addWidget(infoSlot_);
-    // 履歴タブ
-    infoHistory_ = new InfoWidget(this);
-    ui->historyLayout->addWidget(infoHistory_);
-    
-    // スロットリストを読み込み
-    QString slotListPath = QCoreApplication::applicationDirPath() + "/slotList.txt";
-    auto categories = loadSlotList(slotListPath);
-    populateSlotComboBox(ui->slotComboBox, categories);
-    
-    // 初期選択を "None" に
-    int noneIndex = ui->slotComboBox->findText("None");
-    if (noneIndex != -1)
-    ui->slotComboBox->setCurrentIndex(noneIndex);
-    
+    // 履歴タブとスロットリストは表示後に作る
+    connect(ui->mainTabWidget, &QTabWidget::currentChanged, this, [this](int index) {
+        if (ui->mainTabWidget->widget(index) == ui->historyTab) {
+            ensureHistoryWidget();
+            loadHistoryRollup(ConfigManager::instance().get("LogDirectory").toString());
+        }
+    });
+
     ui->pathEdit->setText(ConfigManager::instance().get("FilePath").toString());
     ui->chatPrefixEdit->setText(ConfigManager::instance().get("ChatPrefix").toString());
     ui->logDirEdit->setText(ConfigManager::instance().get("LogDirectory").toString());
     ui->saveLogCheckBox->setChecked(ConfigManager::instance().get("EnableLogSave").toBool());
+    ui->compressLogCheckBox->setChecked(ConfigManager::instance().get("EnableLogCompression").toBool());
 
     ui->pauseButton->setText("一時停止");
+
+    // 履歴の期間（開始日は最小値で「指定なし」）
+    ui->historyFromDate->setMinimumDate(QDate(2000, 1, 1));
+    ui->historyFromDate->setDate(ui->historyFromDate->minimumDate());
+    ui->historyToDate->setDate(QDate::currentDate());
+    ui->historyBucketTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->analyticsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    // ログの絞り込み（入力のたびに索引を引き直す）
+    connect(ui->logTypeFilterCombo, &QComboBox::currentIndexChanged, this, &MainWindow::applyLogFilter);
+    connect(ui->logRoleFilterCombo, &QComboBox::currentIndexChanged, this, &MainWindow::applyLogFilter);
+    connect(ui->logMinAmountEdit, &QLineEdit::textChanged, this, &MainWindow::applyLogFilter);
+    connect(ui->logRecentMinutesSpin, &QSpinBox::valueChanged, this, &MainWindow::applyLogFilter);
+    connect(ui->logSearchEdit, &QLineEdit::textChanged, this, &MainWindow::applyLogFilter);
+
+    StartupTimer::mark("main window constructed");
 }
 
 MainWindow::~MainWindow()
@@ -66,7 +88,75 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+void MainWindow::showEvent(QShowEvent* event) {
+    QMainWindow::showEvent(event);
+
+    if (slotListRequested_) return;
+    slotListRequested_ = true;
+
+    StartupTimer::mark("window shown");
+    loadSlotList();
+}
+
+void MainWindow::loadSlotList() {
+    // 一覧の読み込みと索引作りは別スレッドで行い、描画を待たせない
+    const QString slotListPath = QCoreApplication::applicationDirPath() + "/slotList.txt";
+
+    auto* watcher = new QFutureWatcher<SlotCatalog>(this);
+    connect(watcher, &QFutureWatcher<SlotCatalog>::finished, this, [this, watcher]() {
+        installSlotList(watcher->future().takeResult());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run([slotListPath]() {
+        SlotCatalog catalog;
+        catalog.load(slotListPath);
+        return catalog;
+    }));
+}
+
+void MainWindow::installSlotList(SlotCatalog catalog) {
+    slotCatalog_ = std::move(catalog);
+    StartupTimer::mark("slot list loaded");
+
+    // setModel は先頭行を選ぶので、読み込み中に入力された名前は先に取っておく
+    const QString typedName = ui->slotComboBox->lineEdit()->text();
+
+    // 一覧はスクロールした分だけ作る
+    slotModel_ = new SlotListModel(&slotCatalog_, this);
+    ui->slotComboBox->setModel(slotModel_);
+
+    // 入力すると索引で絞り込んだ候補を出す
+    slotSearchModel_ = new SlotListModel(&slotCatalog_, this);
+    auto* completer = new QCompleter(slotSearchModel_, this);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    ui->slotComboBox->setCompleter(completer);
+    connect(ui->slotComboBox->lineEdit(), &QLineEdit::textEdited, this, [this, completer](const QString& text) {
+        slotSearchModel_->setFilter(text);
+        if (!text.trimmed().isEmpty())
+            completer->complete();
+    });
+
+    // 初期選択を "None" に（読み込み中に入力されていればその名前に戻す）
+    if (typedName.isEmpty()) {
+        const int noneIndex = ui->slotComboBox->findText("None");
+        if (noneIndex >= 0)
+            ui->slotComboBox->setCurrentIndex(noneIndex);
+        else
+            ui->slotComboBox->setCurrentText("None");   // まだ読み込んでいない行にある
+    } else {
+        ui->slotComboBox->setCurrentText(typedName);
+    }
+}
+
+void MainWindow::ensureHistoryWidget() {
+    if (infoHistory_) return;
+
+    infoHistory_ = new InfoWidget(this);
+    ui->historyLayout->insertWidget(ui->historyLayout->indexOf(ui->analyticsGroup), infoHistory_);
+}
+
 void MainWindow::on_startButton_clicked() {
+    // 一覧の読み込み中でも入力欄の名前で始められる
     startTime_ = QDateTime::currentDateTime();
 
     QString path = ui->pathEdit->text();
@@ -74,6 +164,7 @@ void MainWindow::on_startButton_clicked() {
     QString slotName = ui->slotComboBox->currentText().trimmed();
     QString logDir = ui->logDirEdit->text().trimmed();
     bool enableSave = ui->saveLogCheckBox->isChecked();
+    bool compressLog = ui->compressLogCheckBox->isChecked();
 
     // ログファイルパスが無効なら警告
     if (!QFile::exists(path)) {
@@ -87,6 +178,12 @@ void MainWindow::on_startButton_clicked() {
             QMessageBox::warning(this, "警告", "スロット名が空です。記録できません。");
             return;
         }
+        // 自由入力の名前はそのままファイル名になるので、ディレクトリの外に出る名前は受け付けない
+        if (!SlotCatalog::isFileNameSafe(slotName)) {
+            QMessageBox::warning(this, "警告",
+                "スロット名に使えない文字が含まれています（/ \\ : * ? \" < > | や \"..\"）。記録できません。");
+            return;
+        }
         QDir dir(logDir);
         if (!dir.exists()) {
             if (!dir.mkpath(".")) {
@@ -96,6 +193,10 @@ void MainWindow::on_startButton_clicked() {
         }
     }
 
+    // 終了時に集計へ追加するので、記録中に裏で読み込んでおく
+    if (enableSave)
+        loadHistoryRollup(logDir);
+
 
     // 設定をConfigManagerに保存
     ConfigManager::instance().set("FilePath", path);
@@ -103,14 +204,17 @@ void MainWindow::on_startButton_clicked() {
     ConfigManager::instance().set("SlotName", slotName);
     ConfigManager::instance().set("LogDirectory", logDir);
     ConfigManager::instance().set("EnableLogSave", enableSave);
+    ConfigManager::instance().set("EnableLogCompression", compressLog);
 
     ConfigManager::instance().save();
 
     // slotlogファイルのパスを作成
+    logFilePath_.clear();
     if (enableSave) {
-        QString baseName = QString("%1_log_%2.log").arg(slotName, startTime_.toString("yyyyMMdd_HHmmss"));
+        // 圧縮時は拡張子で形式を区別する（SessionLogFile が拡張子を見て書き分ける）
+        QString baseName = QString("%1_log_%2%3").arg(slotName, startTime_.toString("yyyyMMdd_HHmmss"),
+                                                     compressLog ? SessionLogFile::kCompressedSuffix : ".log");
         logFilePath_ = QDir(logDir).filePath(baseName);
-        logFile_ = new QFile(logFilePath_, this); 
     }
 
     infoSlot_->setSlotName(slotName);
@@ -119,14 +223,44 @@ void MainWindow::on_startButton_clicked() {
     controller_ = new SlotTabController(
         watcher_, 
         infoSlot_, 
-        ui->textLogView, 
+        ui->logListView, 
         enableSave, 
-        logFile_, 
+        logFilePath_, 
         this
     );
 
-    ui->textLogView->clear();
+    // オーバーレイ配信（有効時のみ、127.0.0.1 で待ち受け）
+    auto config = ConfigManager::instance().snapshot();
+    if (config->overlayServerEnabled) {
+        if (!overlay_)
+            overlay_ = new OverlayServer(this);
+        if (!overlay_->isListening()) {
+            // quint16 に丸めると別のポートで待ち受けてしまうので範囲外は開始しない
+            if (!config->isOverlayServerPortValid()) {
+                QMessageBox::warning(this, "警告",
+                    QString("オーバーレイ配信のポート番号が不正です（%1）。1〜65535 を指定してください。").arg(config->overlayServerPort));
+            } else if (!overlay_->listen(static_cast<quint16>(config->overlayServerPort))) {
+                QMessageBox::warning(this, "警告", QString("オーバーレイ配信を開始できません（ポート %1）。").arg(config->overlayServerPort));
+            }
+        }
+        overlay_->reset(slotName);
+        connect(controller_, &SlotTabController::statsChanged, overlay_, &OverlayServer::setStats);
+        connect(controller_, &SlotTabController::roleCountChanged, overlay_, &OverlayServer::setRoleCount);
+    }
+
+    // 絞り込み用の役一覧は新しい役が出るたびに追加
+    ui->logRoleFilterCombo->blockSignals(true);
+    while (ui->logRoleFilterCombo->count() > 1)
+        ui->logRoleFilterCombo->removeItem(1);
+    ui->logRoleFilterCombo->setCurrentIndex(0);
+    ui->logRoleFilterCombo->blockSignals(false);
+    connect(controller_, &SlotTabController::roleCountChanged, this, [this](const QString& role) {
+        if (ui->logRoleFilterCombo->findText(role) == -1)
+            ui->logRoleFilterCombo->addItem(role);
+    });
+
     infoSlot_->clearStats(); 
+    applyLogFilter();
 
     ui->stackedWidget->setCurrentIndex(1);
     watcher_->start();
@@ -167,6 +301,19 @@ void MainWindow::on_stopButton_clicked() {
         QString baseName = QString("%1_info_%2.log").arg(slotName, startTime_.toString("yyyyMMdd_HHmmss"));
         QString infoPath = QDir(dir).filePath(baseName);
 
+        controller_->finishSession();
+
+        // 時間ごとの集計に追加（_info_ ファイルより先に登録して取り込みと重複させない）
+        // 集計の読み込みが終わっていなければ、終わったあとに追加する
+        // （その間に _info_ ファイルが取り込まれた場合は開始時刻の1時間にまとめて計上される）
+        const QString sessionKey = QFileInfo(baseName).completeBaseName();
+        auto hourly = HistoryRollup::hourlyFromIndex(controller_->index(), controller_->roles(), startTime_);
+        auto addSession = [this, slotName, sessionKey, hourly]() {
+            rollup_->addSession(slotName, sessionKey, hourly);
+            rollup_->save();
+        };
+        loadHistoryRollup(dir, addSession);
+
         QFile infoFile(infoPath);
         if (infoFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
             QTextStream out(&infoFile);
@@ -258,95 +405,204 @@ void MainWindow::on_historyLoadButton_clicked() {
     QString slotName = ui->historySlotEdit->text().trimmed();
     QString logDir = ConfigManager::instance().get("LogDirectory").toString();
 
-    QDir dir(logDir);
-    QStringList filters = { QString("%1_info_*.log").arg(slotName) };
-    QStringList fileList = dir.entryList(filters, QDir::Files, QDir::Name);
-
-    int totalSpent = 0;
-    int totalGained = 0;
-    int totalSpin = 0;
-    QMap<QString, int> totalRoleCounts;
-
-    for (const QString& fileName : fileList) {
-        QFile file(dir.filePath(fileName));
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) continue;
-
-        QTextStream in(&file);
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-
-            if (line.startsWith("支出:")) {
-                totalSpent += extractNumber(line);
-            } else if (line.startsWith("収入:")) {
-                totalGained += extractNumber(line);
-            } else if (line.startsWith("回転数:")) {
-                totalSpin += extractNumber(line);
-            } else if (line.contains(":") && line.contains("回")) {
-                QRegularExpression re(R"(^(.+?):\s*(\d+)回)");
-                QRegularExpressionMatch m = re.match(line);
-                if (m.hasMatch()) {
-                    QString role = m.captured(1).trimmed();
-                    int count = m.captured(2).toInt();
-                    totalRoleCounts[role] += count;
-                }
-            }
-        }
+    // 読み込み中なら終わってからやり直す
+    if (!historyRollupReady(logDir)) {
+        ui->historyLoadButton->setEnabled(false);
+        loadHistoryRollup(logDir, [this]() {
+            ui->historyLoadButton->setEnabled(true);
+            on_historyLoadButton_clicked();
+        });
+        return;
+    }
+    HistoryRollup& rollup = *rollup_;
+    const auto granularity = static_cast<RollupGranularity>(ui->historyGranularityCombo->currentIndex());
+
+    QDateTime from, to;
+    historyRange(from, to);
+    from = QDateTime::fromSecsSinceEpoch(HistoryRollup::bucketStart(from.toSecsSinceEpoch(), granularity));
+
+    const auto buckets = rollup.buckets(slotName, granularity, from, to);
+
+    RollupBucket total;
+    QLocale locale = QLocale::system();
+    const QString format = granularity == RollupGranularity::Hour ? "yyyy/MM/dd HH:00"
+                         : granularity == RollupGranularity::Day ? "yyyy/MM/dd"
+                         : "yyyy/MM";
+
+    ui->historyBucketTable->setRowCount(static_cast<int>(buckets.size()));
+    int row = 0;
+    for (const auto& [start, bucket] : buckets) {
+        total.add(bucket);
+
+        const qint64 net = bucket.gained - bucket.spent;
+        ui->historyBucketTable->setItem(row, 0, new QTableWidgetItem(QDateTime::fromSecsSinceEpoch(start).toString(format)));
+        ui->historyBucketTable->setItem(row, 1, new QTableWidgetItem(locale.toString(bucket.spent)));
+        ui->historyBucketTable->setItem(row, 2, new QTableWidgetItem(locale.toString(bucket.gained)));
+        ui->historyBucketTable->setItem(row, 3, new QTableWidgetItem(QString("%1%2").arg(net >= 0 ? "+" : "").arg(locale.toString(net))));
+        ui->historyBucketTable->setItem(row, 4, new QTableWidgetItem(locale.toString(bucket.spins)));
+        row++;
     }
+
+    // 今週（月曜始まり）と先週の比較
+    const QDate today = QDate::currentDate();
+    const QDate thisMonday = today.addDays(1 - today.dayOfWeek());
+    auto weekTotal = [&](const QDate& monday) {
+        return rollup.total(slotName, RollupGranularity::Day,
+                            QDateTime(monday, QTime(0, 0)), QDateTime(monday.addDays(7), QTime(0, 0)));
+    };
+    auto describe = [&](const RollupBucket& bucket) {
+        const qint64 net = bucket.gained - bucket.spent;
+        return QString("収支 %1%2（%3回転）")
+            .arg(net >= 0 ? "+" : "")
+            .arg(locale.toString(net))
+            .arg(locale.toString(bucket.spins));
+    };
+    ui->historyCompareLabel->setText(QString("今週: %1 / 先週: %2")
+        .arg(describe(weekTotal(thisMonday)), describe(weekTotal(thisMonday.addDays(-7)))));
+
     // infoHistory_ に統計更新
+    ensureHistoryWidget();
     infoHistory_->setSlotName(slotName);
-    infoHistory_->setStats(totalSpent, totalGained, totalSpin);
-    infoHistory_->updateRoleTable(totalRoleCounts);
+    infoHistory_->setStats(total.spent, total.gained, total.spins);
+    infoHistory_->updateRoleTable(total.roleCount);
 }
 
-int MainWindow::extractNumber(const QString& line) {
-    QRegularExpression re(R"((\d+))");
-    QRegularExpressionMatch m = re.match(line);
-    if (m.hasMatch()) {
-        return m.captured(1).toInt();
+void MainWindow::on_analyticsRunButton_clicked() {
+    QString logDir = ConfigManager::instance().get("LogDirectory").toString();
+    if (!historyRollupReady(logDir)) {
+        ui->analyticsRunButton->setEnabled(false);
+        loadHistoryRollup(logDir, [this]() {
+            ui->analyticsRunButton->setEnabled(true);
+            on_analyticsRunButton_clicked();
+        });
+        return;
     }
-    return 0;
-}
+    HistoryRollup& rollup = *rollup_;
 
-QList<SlotCategory> MainWindow::loadSlotList(const QString& path) {
-    QList<SlotCategory> result;
-    QFile file(path);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return result;
-
-    QTextStream in(&file);
-    SlotCategory current{"その他", {}};
-
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (line.isEmpty()) continue;
-
-        if (line.startsWith("[") && line.endsWith("]")) {
-            if (!current.items.isEmpty()) 
-                result.append(current);
-            current.label = line.mid(1, line.length() - 2);
-            current.items.clear();
-        } else {
-            current.items << line;
-        }
+    QStringList patterns;
+    for (const QString& pattern : ui->analyticsPatternEdit->text().split(',', Qt::SkipEmptyParts)) {
+        if (!pattern.trimmed().isEmpty())
+            patterns << pattern.trimmed();
     }
-    if (!current.items.isEmpty()) 
-        result.append(current);
-    return result;
+
+    QDateTime from, to;
+    historyRange(from, to);
+
+    const SlotAnalytics analytics(&rollup);
+    const std::vector<SlotSummary> summaries =
+        analytics.query(patterns, ui->analyticsGroupCheckBox->isChecked(), from, to);
+
+    QLocale locale = QLocale::system();
+    QTableWidget* table = ui->analyticsTable;
+    table->setSortingEnabled(false);  // 追加中に並べ替わらないように
+    table->setRowCount(static_cast<int>(summaries.size()));
+
+    int row = 0;
+    for (const SlotSummary& summary : summaries) {
+        const qint64 net = summary.net();
+        const QString name = summary.slotCount > 1
+            ? QString("%1（%2台）").arg(summary.name).arg(summary.slotCount)
+            : summary.name;
+        table->setItem(row, 0, new QTableWidgetItem(name));
+        table->setItem(row, 1, new NumericItem(locale.toString(summary.total.spent), double(summary.total.spent)));
+        table->setItem(row, 2, new NumericItem(locale.toString(summary.total.gained), double(summary.total.gained)));
+        table->setItem(row, 3, new NumericItem(QString("%1%2").arg(net >= 0 ? "+" : "").arg(locale.toString(net)), double(net)));
+        table->setItem(row, 4, new NumericItem(locale.toString(summary.total.spins), summary.total.spins));
+        table->setItem(row, 5, new NumericItem(QString::number(summary.rtp(), 'f', 2), summary.rtp()));
+        table->setItem(row, 6, new QTableWidgetItem(summary.topRole()));
+        row++;
+    }
+
+    // 初期表示は収支の大きい順
+    table->setSortingEnabled(true);
+    table->sortItems(3, Qt::DescendingOrder);
+
+    QStringList roles;
+    for (const auto& [role, count] : SlotAnalytics::topRoles(summaries, 5))
+        roles << QString("%1 %2回").arg(role, locale.toString(count));
+    ui->analyticsRoleLabel->setText(roles.isEmpty() ? QString() : "よく出た役: " + roles.join(" / "));
 }
 
-void MainWindow::populateSlotComboBox(QComboBox* comboBox, const QList<SlotCategory>& categories) {
-    auto* model = new QStandardItemModel(comboBox);
+void MainWindow::historyRange(QDateTime& from, QDateTime& to) const {
+    // 期間（開始日が最小値なら指定なし、終了日は当日を含む）
+    from = QDateTime::fromSecsSinceEpoch(0);
+    if (ui->historyFromDate->date() != ui->historyFromDate->minimumDate())
+        from = QDateTime(ui->historyFromDate->date(), QTime(0, 0));
+    to = QDateTime(ui->historyToDate->date().addDays(1), QTime(0, 0));
+}
 
-    for (const SlotCategory& category : categories) {
-        QStandardItem* headerItem = new QStandardItem("— " + category.label + " —");
-        headerItem->setFlags(Qt::NoItemFlags);  // 非選択
-        headerItem->setForeground(Qt::gray);
-        model->appendRow(headerItem);
+bool MainWindow::historyRollupReady(const QString& logDir) const {
+    return rollup_ && rollup_->logDir() == logDir;
+}
 
-        for (const QString& item : category.items) {
-            QStandardItem* slotItem = new QStandardItem(item);
-            model->appendRow(slotItem);
-        }
+void MainWindow::loadHistoryRollup(const QString& logDir, std::function<void()> then) {
+    // 読み込み済みなら読み直さない（記録の追加は rollup_ に対して行っているので置き換えると失われる）
+    if (historyRollupReady(logDir)) {
+        if (then)
+            then();
+        return;
     }
+    if (then)
+        rollupWaiters_.push_back({ logDir, std::move(then) });
+    if (rollupLoadingDir_ == logDir) return;
+    rollupLoadingDir_ = logDir;
+
+    // 集計ファイルより前の記録や、集計されずに残った記録の取り込みは _info_ ファイルを
+    // 全部読むので別スレッドで行う。保存は GUI スレッドだけで行う
+    struct LoadedRollup {
+        std::shared_ptr<HistoryRollup> rollup;
+        bool imported = false;
+    };
+    auto* watcher = new QFutureWatcher<LoadedRollup>(this);
+    connect(watcher, &QFutureWatcher<LoadedRollup>::finished, this, [this, watcher]() {
+        LoadedRollup loaded = watcher->future().result();
+        watcher->deleteLater();
+
+        // 読み込み中に記録先が変わっていたら捨てる
+        if (loaded.rollup->logDir() != rollupLoadingDir_) return;
+        rollupLoadingDir_.clear();
+        rollup_ = std::move(loaded.rollup);
+        if (loaded.imported)
+            rollup_->save();
+
+        const QString dir = rollup_->logDir();
+        std::vector<RollupWaiter> waiters;
+        std::swap(waiters, rollupWaiters_);
+        for (RollupWaiter& waiter : waiters) {
+            if (waiter.logDir == dir)
+                waiter.then();
+            else
+                rollupWaiters_.push_back(std::move(waiter));
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([logDir]() {
+        LoadedRollup loaded;
+        loaded.rollup = std::make_shared<HistoryRollup>(logDir);
+        loaded.rollup->load();
+        loaded.imported = loaded.rollup->importInfoFiles() > 0;
+        return loaded;
+    }));
+}
+
+void MainWindow::applyLogFilter() {
+    if (!controller_) return;
+
+    EventQuery query;
+    query.type = ui->logTypeFilterCombo->currentIndex() - 1;  // 先頭は「すべて」
+
+    if (ui->logRoleFilterCombo->currentIndex() > 0)
+        query.roleId = controller_->roles().find(ui->logRoleFilterCombo->currentText());
+
+    bool ok = false;
+    qint64 minAmount = ui->logMinAmountEdit->text().remove(',').trimmed().toLongLong(&ok);
+    if (ok) query.minAmount = minAmount;
+
+    // 窓は新しい行が来るたびに最新の行から測り直す
+    int minutes = ui->logRecentMinutesSpin->value();
+    if (minutes > 0)
+        query.recentSeconds = qint64(minutes) * 60;
+
+    query.text = ui->logSearchEdit->text();
 
-    comboBox->setModel(model);
+    controller_->setFilter(query);
 }
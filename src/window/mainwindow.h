@@ -5,19 +5,21 @@
 #include <QString>
 #include <QDateTime>
 #include <QComboBox>
+#include <functional>
+#include <memory>
+#include <vector>
 
+#include "history_rollup.h"
 #include "log_watcher.h"
+#include "overlay_server.h"
+#include "slot_catalog.h"
+#include "slot_list_model.h"
 #include "slot_tab_controller.h"
 
 namespace Ui {
 class MainWindow;
 }
 
-struct SlotCategory {
-    QString label;
-    QStringList items;
-};
-
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -26,6 +28,9 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void showEvent(QShowEvent* event) override;
+
 private slots:
     void on_startButton_clicked();
     void on_pauseButton_clicked();
@@ -35,23 +40,41 @@ private slots:
     void on_fileSelectButton_clicked();
     void on_editSlotListButton_clicked();
     void on_historyLoadButton_clicked();
+    void on_analyticsRunButton_clicked();
+    void applyLogFilter();
 
 private:
-    int extractNumber(const QString& line);
-    QList<SlotCategory> loadSlotList(const QString& path);
-    void populateSlotComboBox(QComboBox* comboBox, const QList<SlotCategory>& categories);
+    // 集計を別スレッドで読み込み、終わったら then を呼ぶ
+    void loadHistoryRollup(const QString& logDir, std::function<void()> then = {});
+    bool historyRollupReady(const QString& logDir) const;
+    void historyRange(QDateTime& from, QDateTime& to) const;
+    void loadSlotList();
+    void installSlotList(SlotCatalog catalog);
+    void ensureHistoryWidget();
 
     Ui::MainWindow *ui;
 
     QDateTime startTime_;
     QString logFilePath_;
-    QFile *logFile_;
     bool isPaused_ = false;
+    bool slotListRequested_ = false;
 
     InfoWidget* infoSlot_ = nullptr;
     InfoWidget* infoHistory_ = nullptr;
     LogWatcher* watcher_ = nullptr;
     SlotTabController* controller_ = nullptr;
+    OverlayServer* overlay_ = nullptr;
+    SlotCatalog slotCatalog_;
+    SlotListModel* slotModel_ = nullptr;
+    SlotListModel* slotSearchModel_ = nullptr;   // 入力補完用（絞り込み中）
+    std::shared_ptr<HistoryRollup> rollup_;  // 記録開始時か履歴タブで使うときに読み込む
+
+    struct RollupWaiter {
+        QString logDir;
+        std::function<void()> then;
+    };
+    QString rollupLoadingDir_;                 // 読み込み中の記録先
+    std::vector<RollupWaiter> rollupWaiters_;  // 読み込み後に行う処理
 };
 
 #endif // MAINWINDOW_H
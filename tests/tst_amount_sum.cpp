@@ -0,0 +1,124 @@
+#include <QtTest>
+#include <limits>
+#include <vector>
+
+#include "amount_sum.h"
+
+namespace {
+
+constexpr qint64 kMax = std::numeric_limits<qint64>::max();
+constexpr qint64 kMin = std::numeric_limits<qint64>::min();
+
+// 1件ずつ addAmount で足した結果（sumAmounts の期待値）
+qint64 referenceSum(const std::vector<qint64>& values, bool& ok)
+{
+    qint64 total = 0;
+    ok = true;
+    for (qint64 value : values)
+        ok &= addAmount(total, value);
+    return total;
+}
+
+} // namespace
+
+class TestAmountSum : public QObject {
+    Q_OBJECT
+
+private slots:
+    void addAmountSaturates();
+    void smallValues_data();
+    void smallValues();
+    void nearMaxSaturates_data();
+    void nearMaxSaturates();
+    void negativeValues();
+};
+
+void TestAmountSum::addAmountSaturates()
+{
+    qint64 total = kMax - 1;
+    QVERIFY(addAmount(total, 1));
+    QCOMPARE(total, kMax);
+    QVERIFY(!addAmount(total, 1));
+    QCOMPARE(total, kMax);
+
+    total = kMin + 1;
+    QVERIFY(addAmount(total, -1));
+    QVERIFY(!addAmount(total, -1));
+    QCOMPARE(total, kMin);
+}
+
+void TestAmountSum::smallValues_data()
+{
+    QTest::addColumn<int>("count");
+
+    // ブロック（1024件）とベクトル幅（4件）の端数を含む長さ
+    for (int count : { 0, 1, 3, 5, 1023, 1024, 1025, 2049, 4099 })
+        QTest::newRow(qPrintable(QString::number(count))) << count;
+}
+
+void TestAmountSum::smallValues()
+{
+    QFETCH(int, count);
+
+    std::vector<qint64> values(count);
+    for (int i = 0; i < count; ++i)
+        values[i] = (qint64(i) * 7919) % 100000;
+
+    bool expectedOk;
+    const qint64 expected = referenceSum(values, expectedOk);
+    bool overflow = true;
+    QCOMPARE(sumAmounts(values.data(), values.size(), &overflow), expected);
+    QVERIFY(!overflow);
+}
+
+void TestAmountSum::nearMaxSaturates_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("bigAt");
+
+    // 大きい値がベクトル部分にある場合と端数部分にある場合
+    QTest::newRow("vector part") << 1030 << 0;
+    QTest::newRow("scalar tail") << 1030 << 1029;
+    QTest::newRow("short tail only") << 3 << 2;
+    QTest::newRow("second block tail") << 2051 << 2050;
+}
+
+void TestAmountSum::nearMaxSaturates()
+{
+    QFETCH(int, count);
+    QFETCH(int, bigAt);
+
+    std::vector<qint64> values(count, 1000);
+    values[bigAt] = kMax - 10;
+
+    bool overflow = false;
+    QCOMPARE(sumAmounts(values.data(), values.size(), &overflow), kMax);
+    QVERIFY(overflow);
+
+    // INT64_MAX 同士も同じく上限で止まる
+    std::vector<qint64> maxes(count, kMax);
+    QCOMPARE(sumAmounts(maxes.data(), maxes.size(), &overflow), kMax);
+    QVERIFY(overflow);
+}
+
+void TestAmountSum::negativeValues()
+{
+    // 負の値を含むブロックは1件ずつの加算に落ちる
+    std::vector<qint64> values(1027);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = (i % 3 == 0) ? -qint64(i) * 1000 : qint64(i);
+
+    bool expectedOk;
+    const qint64 expected = referenceSum(values, expectedOk);
+    bool overflow = true;
+    QCOMPARE(sumAmounts(values.data(), values.size(), &overflow), expected);
+    QVERIFY(!overflow);
+
+    // 下限に張り付く場合
+    std::vector<qint64> mins(5, kMin);
+    QCOMPARE(sumAmounts(mins.data(), mins.size(), &overflow), kMin);
+    QVERIFY(overflow);
+}
+
+QTEST_APPLESS_MAIN(TestAmountSum)
+#include "tst_amount_sum.moc"
@@ -0,0 +1,178 @@
+#include <QtTest>
+#include <limits>
+
+#include "event_index.h"
+
+namespace {
+
+constexpr size_t kNoLimit = std::numeric_limits<size_t>::max();
+
+// 10秒ごとに 支払い → 当たり役 → 受け取り を繰り返す索引（行 3k, 3k+1, 3k+2）
+//   支払いは 100 円、受け取りは 100 * (k + 1) 円、役は k が偶数なら 0、奇数なら 1
+void fillSpins(EventIndex& index, int spins, qint32 startSeconds = 1000)
+{
+    for (int k = 0; k < spins; ++k) {
+        const qint32 seconds = startSeconds + k * 10;
+        const quint32 role = k % 2;
+        index.append(GambleLogType::Payment, seconds, 100, kNoRole);
+        index.append(GambleLogType::Role, seconds, 0, role);
+        index.append(GambleLogType::Gain, seconds, 100 * (k + 1), role);
+    }
+}
+
+std::vector<quint32> rows(std::initializer_list<quint32> values)
+{
+    return std::vector<quint32>(values);
+}
+
+} // namespace
+
+class TestEventIndex : public QObject {
+    Q_OBJECT
+
+private slots:
+    void byTypeAndRole();
+    void amountRange();
+    void timeRange();
+    void limitKeepsNewest();
+    void textNeedsLookup();
+    void recentWindowSlides();
+    void dayRollover();
+    void sumAmount();
+};
+
+void TestEventIndex::byTypeAndRole()
+{
+    EventIndex index;
+    fillSpins(index, 4);
+
+    EventQuery query;
+    query.type = static_cast<int>(GambleLogType::Payment);
+    QCOMPARE(index.search(query, kNoLimit), rows({ 0, 3, 6, 9 }));
+
+    query = EventQuery();
+    query.roleId = 1;
+    QCOMPARE(index.search(query, kNoLimit), rows({ 4, 5, 10, 11 }));
+
+    query.type = static_cast<int>(GambleLogType::Gain);
+    QCOMPARE(index.search(query, kNoLimit), rows({ 5, 11 }));
+
+    // 出ていない役
+    query = EventQuery();
+    query.roleId = 7;
+    QVERIFY(index.search(query, kNoLimit).empty());
+}
+
+void TestEventIndex::amountRange()
+{
+    EventIndex index;
+    fillSpins(index, 5);
+
+    EventQuery query;
+    query.type = static_cast<int>(GambleLogType::Gain);
+    query.minAmount = 200;
+    query.maxAmount = 400;
+    QCOMPARE(index.search(query, kNoLimit), rows({ 5, 8, 11 }));
+}
+
+void TestEventIndex::timeRange()
+{
+    EventIndex index;
+    fillSpins(index, 5);
+
+    EventQuery query;
+    query.type = static_cast<int>(GambleLogType::Payment);
+    query.fromTime = 1010;
+    query.toTime = 1030;
+    QCOMPARE(index.search(query, kNoLimit), rows({ 3, 6, 9 }));
+    QCOMPARE(index.firstRowAt(1010), 3u);
+    QCOMPARE(index.firstRowAt(5000), index.size());
+}
+
+void TestEventIndex::limitKeepsNewest()
+{
+    EventIndex index;
+    fillSpins(index, 5);
+
+    // 新しい方から limit 件を古い順で返す
+    EventQuery query;
+    query.type = static_cast<int>(GambleLogType::Payment);
+    QCOMPARE(index.search(query, 2), rows({ 9, 12 }));
+
+    // 候補の行リストがない条件（全行の走査）でも同じ
+    query = EventQuery();
+    query.minAmount = 300;
+    QCOMPARE(index.search(query, 2), rows({ 11, 14 }));
+}
+
+void TestEventIndex::textNeedsLookup()
+{
+    EventIndex index;
+    fillSpins(index, 3);
+
+    EventQuery query;
+    query.text = "ベル";
+
+    // 本文は索引が持たないので、引き方がなければ一致しない
+    QVERIFY(index.search(query, kNoLimit).empty());
+    QVERIFY(!index.matches(1, query));
+
+    auto text = [&index](quint32 row) {
+        if (index.type(row) != GambleLogType::Role) return QString("支払い");
+        return index.roleId(row) == 0 ? QString("ベルです") : QString("チェリーです");
+    };
+    QCOMPARE(index.search(query, kNoLimit, text), rows({ 1, 7 }));
+    QVERIFY(index.matches(7, query, text));
+}
+
+void TestEventIndex::recentWindowSlides()
+{
+    EventIndex index;
+    fillSpins(index, 3);   // 1000, 1010, 1020
+
+    EventQuery query;
+    query.type = static_cast<int>(GambleLogType::Payment);
+    query.recentSeconds = 10;
+    QVERIFY(!query.isEmpty());
+    QCOMPARE(index.fromTime(query), qint64(1010));
+    QCOMPARE(index.search(query, kNoLimit), rows({ 3, 6 }));
+
+    // 行が増えると窓も進む
+    index.append(GambleLogType::Payment, 1030, 100, kNoRole);
+    QCOMPARE(index.fromTime(query), qint64(1020));
+    QCOMPARE(index.search(query, kNoLimit), rows({ 6, 9 }));
+    QVERIFY(!index.matches(3, query));
+
+    // fromTime の方が新しければそちらを使う
+    query.fromTime = 1025;
+    QCOMPARE(index.fromTime(query), qint64(1025));
+}
+
+void TestEventIndex::dayRollover()
+{
+    EventIndex index;
+    index.append(GambleLogType::Payment, 23 * 3600 + 59 * 60 + 50, 100, kNoRole);
+    index.append(GambleLogType::Payment, 5, 100, kNoRole);
+    index.append(GambleLogType::Payment, kNoLogTime, 100, kNoRole);
+
+    // 0時をまたいでも時刻は戻らない。時刻のない行は直前の時刻
+    QCOMPARE(index.time(1), qint64(24 * 3600 + 5));
+    QCOMPARE(index.time(2), index.time(1));
+    QCOMPARE(index.secondsOfDay(1), 5);
+    QCOMPARE(index.latestTime(), qint64(24 * 3600 + 5));
+}
+
+void TestEventIndex::sumAmount()
+{
+    EventIndex index;
+    fillSpins(index, 4);
+
+    quint32 count = 0;
+    QCOMPARE(index.sumAmount(GambleLogType::Gain, 0, index.size(), &count), qint64(100 + 200 + 300 + 400));
+    QCOMPARE(count, 4u);
+    QCOMPARE(index.sumAmount(GambleLogType::Payment, 3, 9, &count), qint64(200));
+    QCOMPARE(count, 2u);
+}
+
+QTEST_APPLESS_MAIN(TestEventIndex)
+#include "tst_event_index.moc"
@@ -0,0 +1,135 @@
+#include <QtTest>
+
+#include "log_parser.h"
+
+namespace {
+
+const QString kPrefix = QStringLiteral("[CHAT] ");
+
+QList<ParseRuleConfig> man10Rules()
+{
+    return {
+        { "Man10Slot", "Payment", "{amount}円支払いました" },
+        { "Man10Slot", "Gain", "{amount}円受け取りました" },
+        { "Man10Slot", "Lose", "[Man10Slot]外れました" },
+        { "Man10Slot", "Role", "[Man10Slot]おめでとうございます！{role}です！" },
+    };
+}
+
+QString chatLine(const QString& time, const QString& body)
+{
+    return time + " [Render thread/INFO]: " + kPrefix + body;
+}
+
+} // namespace
+
+class TestLogParser : public QObject {
+    Q_OBJECT
+
+private slots:
+    void payment();
+    void role();
+    void rejected_data();
+    void rejected();
+    void formatTime();
+    void batchReusesStorage();
+};
+
+void TestLogParser::payment()
+{
+    RoleTable roles;
+    LogParser parser(kPrefix, man10Rules(), &roles);
+    GambleLogBatch batch;
+
+    QVERIFY(parser.parseLine(chatLine("[12:34:56]", "1,234円支払いました"), batch));
+    QCOMPARE(batch.logs.size(), size_t(1));
+
+    const GambleLog& log = batch.logs[0];
+    QCOMPARE(log.type, GambleLogType::Payment);
+    QCOMPARE(log.amount, qint64(1234));
+    QCOMPARE(log.secondsOfDay, 12 * 3600 + 34 * 60 + 56);
+    QCOMPARE(log.roleId, kNoRole);
+    QCOMPARE(batch.content(log), QStringView(u"1,234円支払いました"));
+}
+
+void TestLogParser::role()
+{
+    RoleTable roles;
+    LogParser parser(kPrefix, man10Rules(), &roles);
+    GambleLogBatch batch;
+    batch.roles = &roles;
+
+    QVERIFY(parser.parseLine(chatLine("[00:00:01]", "[Man10Slot]おめでとうございます！ベルです！"), batch));
+    QVERIFY(parser.parseLine(chatLine("[00:00:02]", "[Man10Slot]おめでとうございます！チェリーです！"), batch));
+    QVERIFY(parser.parseLine(chatLine("[00:00:03]", "[Man10Slot]おめでとうございます！ベルです！"), batch));
+    QCOMPARE(batch.logs.size(), size_t(3));
+
+    // 同じ役名は同じ ID
+    QCOMPARE(batch.logs[0].roleId, batch.logs[2].roleId);
+    QVERIFY(batch.logs[0].roleId != batch.logs[1].roleId);
+    QCOMPARE(batch.roleName(batch.logs[1]), QString("チェリー"));
+    QCOMPARE(roles.size(), 2);
+    QCOMPARE(roles.find(u"ベル"), batch.logs[0].roleId);
+
+    // 本文はアリーナ内で前の行の続きに置かれる
+    QCOMPARE(batch.logs[1].contentOffset, batch.logs[0].contentLength);
+}
+
+void TestLogParser::rejected_data()
+{
+    QTest::addColumn<QString>("line");
+
+    QTest::newRow("no prefix") << QString("[12:00:00] 1,000円支払いました");
+    QTest::newRow("unknown body") << chatLine("[12:00:00]", "こんにちは");
+    QTest::newRow("no digits") << chatLine("[12:00:00]", ",円支払いました");
+    QTest::newRow("amount overflow") << chatLine("[12:00:00]", "99999999999999999999円支払いました");
+    QTest::newRow("empty role") << chatLine("[12:00:00]", "[Man10Slot]おめでとうございます！ です！");
+}
+
+void TestLogParser::rejected()
+{
+    QFETCH(QString, line);
+
+    RoleTable roles;
+    LogParser parser(kPrefix, man10Rules(), &roles);
+    GambleLogBatch batch;
+
+    QVERIFY(!parser.parseLine(line, batch));
+    QVERIFY(batch.isEmpty());
+    QVERIFY(batch.arena.isEmpty());
+}
+
+void TestLogParser::formatTime()
+{
+    QCOMPARE(formatLogTime(0), QString("[00:00:00]"));
+    QCOMPARE(formatLogTime(23 * 3600 + 59 * 60 + 59), QString("[23:59:59]"));
+    QCOMPARE(formatLogTime(kNoLogTime), QString());
+}
+
+void TestLogParser::batchReusesStorage()
+{
+    RoleTable roles;
+    LogParser parser(kPrefix, man10Rules(), &roles);
+    GambleLogBatch batch;
+
+    auto fill = [&]() {
+        for (int i = 0; i < 100; ++i)
+            parser.parseLine(chatLine("[12:00:00]", QString("%1円受け取りました").arg(1000 + i)), batch);
+    };
+
+    fill();
+    const QChar* arenaData = batch.arena.constData();
+    const GambleLog* logData = batch.logs.data();
+
+    // clear() 後に同じ量を入れても確保し直さない
+    batch.clear();
+    QVERIFY(batch.isEmpty());
+    fill();
+    QCOMPARE(batch.logs.size(), size_t(100));
+    QCOMPARE(batch.arena.constData(), arenaData);
+    QCOMPARE(batch.logs.data(), logData);
+    QCOMPARE(batch.logs[99].amount, qint64(1099));
+}
+
+QTEST_APPLESS_MAIN(TestLogParser)
+#include "tst_log_parser.moc"
@@ -0,0 +1,136 @@
+#include <QtTest>
+
+#include "log_parser.h"
+#include "parse_rules.h"
+
+namespace {
+
+QList<ParseRuleConfig> twoPluginRules()
+{
+    return {
+        { "Man10Slot", "Payment", "{amount}円支払いました" },
+        { "Man10Slot", "Gain", "{amount}円受け取りました" },
+        { "Man10Slot", "Lose", "[Man10Slot]外れました" },
+        { "Man10Slot", "Role", "[Man10Slot]おめでとうございます！{role}です！" },
+        // 別プラグイン。先頭のリテラルを共有し、同じノードでリテラルと {amount} に分かれる
+        { "Other", "Gain", "[Man10Slot]{amount}枚獲得" },
+        { "Other", "Role", "[Man10Slot]おめでとうございます！{role}！" },
+    };
+}
+
+} // namespace
+
+class TestParseRules : public QObject {
+    Q_OBJECT
+
+private slots:
+    void invalidRulesAreSkipped();
+    void amount();
+    void amountMustBeWhole();
+    void literalAndAmountBranch();
+    void roleTakesLongestSuffix();
+    void roleIsTrimmedAndNonEmpty();
+    void noMatch();
+};
+
+void TestParseRules::invalidRulesAreSkipped()
+{
+    const QList<ParseRuleConfig> rules = {
+        { "A", "Payment", "{amount}円" },
+        { "A", "Unknown", "{amount}円" },          // 種別が不明
+        { "A", "Payment", "支払いました" },         // {amount} がない
+        { "A", "Role", "当たり" },                  // {role} がない
+        { "A", "Lose", "{amount}円負け" },          // Lose に {amount} は置けない
+        { "A", "Role", "{amount}円で{role}" },      // Role に {amount} は置けない
+        { "B", "Payment", "{amount}円" },           // 同じパターンが登録済み
+    };
+    ParseRuleMatcher matcher(rules);
+    QCOMPARE(matcher.ruleCount(), 1);
+}
+
+void TestParseRules::amount()
+{
+    ParseRuleMatcher matcher(twoPluginRules());
+    QCOMPARE(matcher.ruleCount(), 6);
+
+    ParseRuleMatch match;
+    QVERIFY(matcher.match(u"1,234,567円支払いました", match));
+    QCOMPARE(match.type, GambleLogType::Payment);
+    QCOMPARE(match.amount, QStringView(u"1,234,567"));
+    QVERIFY(match.role.isEmpty());
+
+    QVERIFY(matcher.match(u"500円受け取りました", match));
+    QCOMPARE(match.type, GambleLogType::Gain);
+    QCOMPARE(match.amount, QStringView(u"500"));
+}
+
+void TestParseRules::amountMustBeWhole()
+{
+    ParseRuleMatcher matcher(twoPluginRules());
+    ParseRuleMatch match;
+
+    // {amount} は数字とカンマの最長一致。途中に他の文字があれば一致しない
+    QVERIFY(!matcher.match(u"12a3円支払いました", match));
+    QVERIFY(!matcher.match(u"円支払いました", match));
+    // 本文全体に一致する必要がある
+    QVERIFY(!matcher.match(u"100円支払いました！", match));
+}
+
+void TestParseRules::literalAndAmountBranch()
+{
+    ParseRuleMatcher matcher(twoPluginRules());
+    ParseRuleMatch match;
+
+    QVERIFY(matcher.match(u"[Man10Slot]外れました", match));
+    QCOMPARE(match.type, GambleLogType::Lose);
+
+    QVERIFY(matcher.match(u"[Man10Slot]30枚獲得", match));
+    QCOMPARE(match.type, GambleLogType::Gain);
+    QCOMPARE(match.amount, QStringView(u"30"));
+}
+
+void TestParseRules::roleTakesLongestSuffix()
+{
+    ParseRuleMatcher matcher(twoPluginRules());
+    ParseRuleMatch match;
+
+    // "{role}です！" と "{role}！" の両方に一致する場合は長い接尾辞を採る
+    QVERIFY(matcher.match(u"[Man10Slot]おめでとうございます！ビッグボーナスです！", match));
+    QCOMPARE(match.type, GambleLogType::Role);
+    QCOMPARE(match.role, QStringView(u"ビッグボーナス"));
+
+    QVERIFY(matcher.match(u"[Man10Slot]おめでとうございます！チェリー！", match));
+    QCOMPARE(match.role, QStringView(u"チェリー"));
+}
+
+void TestParseRules::roleIsTrimmedAndNonEmpty()
+{
+    ParseRuleMatcher matcher(twoPluginRules());
+    ParseRuleMatch match;
+
+    QVERIFY(matcher.match(u"[Man10Slot]おめでとうございます！ ベル です！", match));
+    QCOMPARE(match.role, QStringView(u"ベル"));
+
+    // "です！" を取ると役名が空になるので短い接尾辞 "！" の方に一致する
+    QVERIFY(matcher.match(u"[Man10Slot]おめでとうございます！です！", match));
+    QCOMPARE(match.role, QStringView(u"です"));
+
+    QVERIFY(!matcher.match(u"[Man10Slot]おめでとうございます！ ！", match));
+}
+
+void TestParseRules::noMatch()
+{
+    ParseRuleMatcher matcher(twoPluginRules());
+    ParseRuleMatch match;
+
+    QVERIFY(!matcher.match(u"", match));
+    QVERIFY(!matcher.match(u"[Man10Slot]", match));
+    QVERIFY(!matcher.match(u"こんにちは", match));
+
+    ParseRuleMatcher empty(QList<ParseRuleConfig>{});
+    QCOMPARE(empty.ruleCount(), 0);
+    QVERIFY(!empty.match(u"100円支払いました", match));
+}
+
+QTEST_APPLESS_MAIN(TestParseRules)
+#include "tst_parse_rules.moc"
@@ -0,0 +1,129 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "slot_catalog.h"
+
+class TestSlotCatalog : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void normalize_data();
+    void normalize();
+    void categories();
+    void searchOrder();
+    void searchFolds();
+    void fileNameSafe_data();
+    void fileNameSafe();
+
+private:
+    QTemporaryDir dir_;
+    SlotCatalog catalog_;
+};
+
+void TestSlotCatalog::initTestCase()
+{
+    QVERIFY(dir_.isValid());
+
+    const QString path = dir_.filePath("slotList.txt");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write(QString(
+        "見出し前スロット\n"
+        "[パチスロ]\n"
+        "マジカルハロウィン\n"
+        "ハナハナ\n"
+        "\n"
+        "[ＢＩＧ系]\n"
+        "BigBonus\n"
+        "スーパーハナハナ\n").toUtf8());
+    file.close();
+
+    QVERIFY(catalog_.load(path));
+}
+
+void TestSlotCatalog::normalize_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("case") << QString("BigBonus") << QString("bigbonus");
+    QTest::newRow("full width") << QString("ＢＩＧ１") << QString("big1");
+    QTest::newRow("katakana") << QString("ハナハナ") << QString("はなはな");
+    QTest::newRow("half width kana") << QString("ﾊﾅﾊﾅ") << QString("はなはな");
+    QTest::newRow("voiced half width") << QString("ﾏｼﾞｶﾙ") << QString("まじかる");
+}
+
+void TestSlotCatalog::normalize()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, expected);
+
+    QCOMPARE(SlotCatalog::normalize(text), expected);
+}
+
+void TestSlotCatalog::categories()
+{
+    QCOMPARE(catalog_.size(), 5u);
+    QCOMPARE(catalog_.name(0), QString("見出し前スロット"));
+
+    const auto& categories = catalog_.categories();
+    QCOMPARE(categories.size(), size_t(3));
+    QCOMPARE(categories[0].label, QString("その他"));
+    QCOMPARE(categories[0].count, 1u);
+    QCOMPARE(categories[1].label, QString("パチスロ"));
+    QCOMPARE(categories[1].first, 1u);
+    QCOMPARE(categories[1].count, 2u);
+    QCOMPARE(categories[2].label, QString("ＢＩＧ系"));
+    QCOMPARE(categories[2].first, 3u);
+}
+
+void TestSlotCatalog::searchOrder()
+{
+    // 空なら全件を一覧の順で
+    QCOMPARE(catalog_.search(u"").size(), size_t(catalog_.size()));
+
+    // 前方一致（ハナハナ）が先、部分一致（スーパーハナハナ）が後
+    const std::vector<quint32> rows = catalog_.search(u"はな");
+    QCOMPARE(rows, (std::vector<quint32>{ 2, 4 }));
+
+    QVERIFY(catalog_.search(u"存在しない").empty());
+}
+
+void TestSlotCatalog::searchFolds()
+{
+    // 大文字小文字・全角半角・カタカナひらがなを区別しない
+    QCOMPARE(catalog_.search(u"ＢＩＧ"), (std::vector<quint32>{ 3 }));
+    QCOMPARE(catalog_.search(u"ﾊﾛｳｨﾝ"), (std::vector<quint32>{ 1 }));
+    QCOMPARE(catalog_.search(u"  ま"), (std::vector<quint32>{ 1 }));
+    // 1文字でも部分一致を引ける
+    QCOMPARE(catalog_.search(u"ー"), (std::vector<quint32>{ 4 }));
+}
+
+void TestSlotCatalog::fileNameSafe_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<bool>("safe");
+
+    QTest::newRow("plain") << QString("マジカルハロウィン") << true;
+    QTest::newRow("full width slash") << QString("Ａ／Ｂ") << true;
+    QTest::newRow("empty") << QString() << false;
+    QTest::newRow("slash") << QString("../x") << false;
+    QTest::newRow("backslash") << QString("a\\b") << false;
+    QTest::newRow("drive") << QString("C:x") << false;
+    QTest::newRow("dot dot") << QString("..") << false;
+    QTest::newRow("reserved") << QString("a?b") << false;
+    QTest::newRow("control") << QString("a\tb") << false;
+    QTest::newRow("trailing dot") << QString("slot.") << false;
+}
+
+void TestSlotCatalog::fileNameSafe()
+{
+    QFETCH(QString, name);
+    QFETCH(bool, safe);
+
+    QCOMPARE(SlotCatalog::isFileNameSafe(name), safe);
+}
+
+QTEST_APPLESS_MAIN(TestSlotCatalog)
+#include "tst_slot_catalog.moc"
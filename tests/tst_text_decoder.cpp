@@ -0,0 +1,125 @@
+#include <QtTest>
+
+#include "text_decoder.h"
+
+namespace {
+
+// chunks を順に渡して変換した結果
+QString decodeChunks(const QString& encoding, const QList<QByteArray>& chunks)
+{
+    TextDecoder decoder(encoding);
+    QString out;
+    for (const QByteArray& chunk : chunks)
+        decoder.decode(chunk.constData(), chunk.size(), out);
+    return out;
+}
+
+// 1バイトずつの境界すべてで分けて変換しても結果が変わらないことを確かめる
+void verifyEverySplit(const QString& encoding, const QByteArray& data, const QString& expected)
+{
+    for (qsizetype at = 0; at <= data.size(); ++at) {
+        const QString got = decodeChunks(encoding, { data.left(at), data.mid(at) });
+        QVERIFY2(got == expected, qPrintable(QString("split at %1").arg(at)));
+    }
+}
+
+} // namespace
+
+class TestTextDecoder : public QObject {
+    Q_OBJECT
+
+private slots:
+    void encodingNames();
+    void shiftJis();
+    void shiftJisSplit();
+    void shiftJisInvalid();
+    void utf8Split();
+    void utf8Invalid_data();
+    void utf8Invalid();
+    void longAsciiRun();
+};
+
+void TestTextDecoder::encodingNames()
+{
+    QCOMPARE(TextDecoder("Shift_JIS").encoding(), TextDecoder::Encoding::ShiftJis);
+    QCOMPARE(TextDecoder("cp932").encoding(), TextDecoder::Encoding::ShiftJis);
+    QCOMPARE(TextDecoder("UTF-8").encoding(), TextDecoder::Encoding::Utf8);
+    QCOMPARE(TextDecoder("").encoding(), TextDecoder::Encoding::Utf8);
+}
+
+void TestTextDecoder::shiftJis()
+{
+    // "[12:00] あ円ｱ" （ひらがな・漢字・半角カナ）
+    const QByteArray data("[12:00] \x82\xA0\x89\x7E\xB1");
+    QCOMPARE(decodeChunks("Shift_JIS", { data }), QString::fromUtf8("[12:00] あ円ｱ"));
+}
+
+void TestTextDecoder::shiftJisSplit()
+{
+    const QByteArray data("\x82\xA0""abc\x89\x7E""\x82\xA2");
+    verifyEverySplit("Shift_JIS", data, QString::fromUtf8("あabc円い"));
+}
+
+void TestTextDecoder::shiftJisInvalid()
+{
+    // 後続バイトでないものが来たら置換文字にして、そのバイトから読み直す
+    QCOMPARE(decodeChunks("Shift_JIS", { QByteArray("\x82 x") }), QString(u"\uFFFD x"));
+    QCOMPARE(decodeChunks("Shift_JIS", { QByteArray("\x82"), QByteArray(" x") }), QString(u"\uFFFD x"));
+    // 先行・後続どちらでもないバイト
+    QCOMPARE(decodeChunks("Shift_JIS", { QByteArray("a\xFD""b") }), QString(u"a\uFFFDb"));
+}
+
+void TestTextDecoder::utf8Split()
+{
+    // 2〜4バイトの文字を含む
+    const QByteArray data = QString::fromUtf8("é あ円 😀!").toUtf8();
+    verifyEverySplit("UTF-8", data, QString::fromUtf8("é あ円 😀!"));
+}
+
+void TestTextDecoder::utf8Invalid_data()
+{
+    QTest::addColumn<QList<QByteArray>>("chunks");
+    QTest::addColumn<QString>("expected");
+
+    // 持ち越した先行バイトの後に ASCII が来たら、ASCII は取り込まずに読み直す
+    QTest::newRow("pending lead then ascii")
+        << QList<QByteArray>{ "\xE3\x81", "A" } << QString(u"\uFFFDA");
+    QTest::newRow("pending lead only then ascii")
+        << QList<QByteArray>{ "\xE3", "AB" } << QString(u"\uFFFDAB");
+    QTest::newRow("pending lead then new lead")
+        << QList<QByteArray>{ "\xE3", "\xE3\x81\x82" } << QString(u"\uFFFDあ");
+    QTest::newRow("truncated before ascii in chunk")
+        << QList<QByteArray>{ "x\xE3""A" } << QString(u"x\uFFFDA");
+    QTest::newRow("stray continuation")
+        << QList<QByteArray>{ "\x81""a" } << QString(u"\uFFFDa");
+    QTest::newRow("overlong")
+        << QList<QByteArray>{ "\xE0\x80\x80" } << QString(u"\uFFFD");
+    QTest::newRow("truncated 4-byte before ascii")
+        << QList<QByteArray>{ "\xF0\x9F\x98", "A" } << QString(u"\uFFFDA");
+    QTest::newRow("surrogate")
+        << QList<QByteArray>{ "\xED\xA0", "\x80" } << QString(u"\uFFFD");
+}
+
+void TestTextDecoder::utf8Invalid()
+{
+    QFETCH(QList<QByteArray>, chunks);
+    QFETCH(QString, expected);
+
+    QCOMPARE(decodeChunks("UTF-8", chunks), expected);
+
+    // 区切る位置によって結果が変わらない
+    verifyEverySplit("UTF-8", chunks.join(), expected);
+}
+
+void TestTextDecoder::longAsciiRun()
+{
+    // ベクトル化した ASCII の区間と、その途中で始まるマルチバイト文字
+    QByteArray data(40, 'a');
+    data.insert(21, QString::fromUtf8("あ").toUtf8());
+    QString expected(40, u'a');
+    expected.insert(21, QString::fromUtf8("あ"));
+    verifyEverySplit("UTF-8", data, expected);
+}
+
+QTEST_APPLESS_MAIN(TestTextDecoder)
+#include "tst_text_decoder.moc"
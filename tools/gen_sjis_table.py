@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+# src/core/sjis_table.cpp を生成する（Python 標準の cp932 コーデックを元にする）
+#   python3 tools/gen_sjis_table.py > src/core/sjis_table.cpp
+
+LEADS = list(range(0x81, 0xA0)) + list(range(0xE0, 0xFD))
+TRAILS = list(range(0x40, 0x7F)) + list(range(0x80, 0xFD))
+
+
+def main():
+    values = []
+    for lead in LEADS:
+        for trail in TRAILS:
+            try:
+                ch = bytes([lead, trail]).decode("cp932")
+                values.append(ord(ch))
+            except UnicodeDecodeError:
+                values.append(0xFFFD)
+
+    print("// このファイルは tools/gen_sjis_table.py で生成されています。直接編集しないでください。")
+    print()
+    print('#include "sjis_table.h"')
+    print()
+    print("const char16_t kSjisDoubleByteTable[kSjisLeadCount * kSjisTrailCount] = {")
+    for i in range(0, len(values), 12):
+        row = ", ".join("0x%04X" % v for v in values[i:i + 12])
+        print("    %s," % row)
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,106 @@
+// --bench 用のメモリ確保回数カウンタ（LD_PRELOAD で読み込む共有ライブラリ）
+// malloc / calloc / realloc を数えてから次のライブラリ（通常は libc）の実装へ渡す。
+// 負荷試験ツール本体には含めず、ツールは gamblelive_allocation_count を実行時に探す。
+//   LD_PRELOAD=./libGambleLiveAllocCount.so ./GambleLiveSoak --bench
+
+#include <dlfcn.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+using MallocFn = void *(*)(size_t);
+using CallocFn = void *(*)(size_t, size_t);
+using ReallocFn = void *(*)(void *, size_t);
+using FreeFn = void (*)(void *);
+
+std::atomic<long long> allocationCount{ 0 };
+
+MallocFn realMalloc = nullptr;
+CallocFn realCalloc = nullptr;
+ReallocFn realRealloc = nullptr;
+FreeFn realFree = nullptr;
+bool resolving = false;
+
+// dlsym 自身が calloc を呼ぶことがあるので、解決し終えるまでは静的な領域から返す（解放はしない）
+alignas(std::max_align_t) char bootstrap[4096];
+size_t bootstrapUsed = 0;
+
+void *bootstrapAlloc(size_t size)
+{
+    constexpr size_t align = alignof(std::max_align_t);
+    size = (size + align - 1) & ~(align - 1);
+    if (size > sizeof(bootstrap) - bootstrapUsed) return nullptr;
+    void *ptr = bootstrap + bootstrapUsed;
+    bootstrapUsed += size;
+    return ptr;
+}
+
+bool isBootstrap(const void *ptr)
+{
+    return ptr >= bootstrap && ptr < bootstrap + sizeof(bootstrap);
+}
+
+void resolve()
+{
+    if (realMalloc || resolving) return;
+    resolving = true;
+    // realMalloc は最後に入れる（解決し終えた印）
+    realCalloc = reinterpret_cast<CallocFn>(dlsym(RTLD_NEXT, "calloc"));
+    realRealloc = reinterpret_cast<ReallocFn>(dlsym(RTLD_NEXT, "realloc"));
+    realFree = reinterpret_cast<FreeFn>(dlsym(RTLD_NEXT, "free"));
+    realMalloc = reinterpret_cast<MallocFn>(dlsym(RTLD_NEXT, "malloc"));
+    resolving = false;
+}
+
+} // namespace
+
+extern "C" {
+
+void *malloc(size_t size)
+{
+    resolve();
+    if (!realMalloc) return bootstrapAlloc(size);
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return realMalloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    resolve();
+    if (!realCalloc) return bootstrapAlloc(count * size);   // 静的な領域なので 0 で埋まっている
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return realCalloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    resolve();
+    if (isBootstrap(ptr)) {
+        // 元の大きさは分からないので、静的な領域の終わりまでを上限に写す
+        void *moved = malloc(size);
+        if (moved)
+            std::memcpy(moved, ptr, std::min<size_t>(size, bootstrap + sizeof(bootstrap) - static_cast<char *>(ptr)));
+        return moved;
+    }
+    if (!realRealloc) return bootstrapAlloc(size);
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return realRealloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    if (!ptr || isBootstrap(ptr)) return;
+    resolve();
+    if (realFree)
+        realFree(ptr);
+}
+
+long long gamblelive_allocation_count()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+} // extern "C"
@@ -0,0 +1,174 @@
+#include <QList>
+#include <QRegularExpression>
+#include <QStringDecoder>
+#include <QStringList>
+#include <QtGlobal>
+
+#ifdef Q_OS_UNIX
+#include <dlfcn.h>
+#endif
+
+#include "config_manager.h"
+#include "ingest_bench.h"
+#include "log_parser.h"
+#include "text_decoder.h"
+
+namespace {
+
+// LogWatcher の1回の読み込みで届く行数の目安（2000 行/秒、10ms 間隔）
+constexpr size_t kLinesPerTick = 32;
+
+// メモリ確保の回数（LD_PRELOAD で alloc_count_preload を読み込んだときだけ数えられる。それ以外は -1）
+qint64 allocations()
+{
+#ifdef Q_OS_UNIX
+    using CountFn = long long (*)();
+    static const auto count = reinterpret_cast<CountFn>(dlsym(RTLD_DEFAULT, "gamblelive_allocation_count"));
+    if (count)
+        return count();
+#endif
+    return -1;
+}
+
+// 旧方式の1行分（文字列をそれぞれ持つ）
+struct LegacyLog {
+    GambleLogType type = GambleLogType::Payment;
+    int amount = 0;
+    QString roleName;
+    QString time;
+    QString content;
+};
+
+bool parseLegacyLine(const QString& line, const QString& chatPrefix, LegacyLog& log)
+{
+    static const QRegularExpression timeExp(R"(\[\d{2}:\d{2}:\d{2}\])");
+    static const QRegularExpression payExp(R"(^([\d,]+)円支払いました$)");
+    static const QRegularExpression gainExp(R"(^([\d,]+)円受け取りました$)");
+    static const QRegularExpression loseExp(R"(^\[Man10Slot\]外れました$)");
+    static const QRegularExpression roleExp(R"(^\[Man10Slot\]おめでとうございます！(.+)です！$)");
+
+    const qsizetype chatIndex = line.indexOf(chatPrefix);
+    if (chatIndex == -1) return false;
+
+    const QString body = line.mid(chatIndex + chatPrefix.length()).trimmed();
+    log.content = body;
+
+    QRegularExpressionMatch m;
+    if ((m = timeExp.match(line)).hasMatch())
+        log.time = m.captured(0);
+
+    if ((m = payExp.match(body)).hasMatch()) {
+        log.type = GambleLogType::Payment;
+        log.amount = m.captured(1).remove(",").toInt();
+        return true;
+    }
+    if ((m = gainExp.match(body)).hasMatch()) {
+        log.type = GambleLogType::Gain;
+        log.amount = m.captured(1).remove(",").toInt();
+        return true;
+    }
+    if (loseExp.match(body).hasMatch()) {
+        log.type = GambleLogType::Lose;
+        return true;
+    }
+    if ((m = roleExp.match(body)).hasMatch()) {
+        log.type = GambleLogType::Role;
+        log.roleName = m.captured(1).trimmed();
+        return true;
+    }
+    return false;
+}
+
+// rounds 回繰り返して一番速かった回を返す
+template <typename Run>
+IngestBenchResult bestOf(int rounds, qint64 lineCount, Run run)
+{
+    IngestBenchResult best;
+    for (int round = 0; round < qMax(1, rounds); ++round) {
+        IngestBenchResult result;
+        result.lines = lineCount;
+
+        const qint64 allocationsBefore = allocations();
+        const qint64 startNs = soakNowNs();
+        result.parsed = run();
+        result.seconds = (soakNowNs() - startNs) / 1e9;
+        if (allocationsBefore >= 0)
+            result.allocations = allocations() - allocationsBefore;
+
+        if (round == 0 || result.seconds < best.seconds)
+            best = result;
+    }
+    return best;
+}
+
+} // namespace
+
+IngestBenchResult benchIngest(const std::vector<SoakLine>& lines, const QString& encoding,
+                              const QString& chatPrefix, int rounds)
+{
+    auto config = ConfigManager::instance().snapshot();
+    RoleTable roles;
+    LogParser parser(chatPrefix, config->parseRules, &roles);
+    TextDecoder decoder(encoding);
+    GambleLogBatch batch;
+    batch.roles = &roles;
+    QString lineText;
+
+    return bestOf(rounds, static_cast<qint64>(lines.size()), [&]() {
+        qint64 parsed = 0;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            if (i % kLinesPerTick == 0) {
+                parsed += static_cast<qint64>(batch.logs.size());
+                batch.clear();
+            }
+
+            // TailReader が返すのは改行を除いた行
+            const QByteArrayView line = QByteArrayView(lines[i].bytes).chopped(1);
+
+            decoder.reset();
+            lineText.truncate(0);
+            decoder.decode(line.data(), line.size(), lineText);
+
+            QStringView text = QStringView(lineText).trimmed();
+            if (!text.isEmpty())
+                parser.parseLine(text, batch);
+        }
+        parsed += static_cast<qint64>(batch.logs.size());
+        batch.clear();
+        return parsed;
+    });
+}
+
+IngestBenchResult benchLegacyIngest(const std::vector<SoakLine>& lines, const QString& encoding,
+                                    const QString& chatPrefix, int rounds)
+{
+    return bestOf(rounds, static_cast<qint64>(lines.size()), [&]() {
+        qint64 parsed = 0;
+        for (size_t first = 0; first < lines.size(); first += kLinesPerTick) {
+            // 1回の読み込み分をまとめて読んでデコード
+            QByteArray rawData;
+            const size_t last = qMin(lines.size(), first + kLinesPerTick);
+            for (size_t i = first; i < last; ++i)
+                rawData += lines[i].bytes;
+
+            QString logText;
+            QStringDecoder codec(encoding.toUtf8().constData());
+            if (codec.isValid()) {
+                logText = codec.decode(rawData);
+            } else {
+                TextDecoder decoder(encoding);
+                decoder.decode(rawData.constData(), rawData.size(), logText);
+            }
+
+            QList<LegacyLog> logs;
+            const QStringList split = logText.split("\n", Qt::SkipEmptyParts);
+            for (const QString& line : split) {
+                LegacyLog log;
+                if (parseLegacyLine(line.trimmed(), chatPrefix, log))
+                    logs.append(log);
+            }
+            parsed += logs.size();
+        }
+        return parsed;
+    });
+}
@@ -0,0 +1,27 @@
+#ifndef INGEST_BENCH_H
+#define INGEST_BENCH_H
+
+#include <QString>
+#include <vector>
+
+#include "soak_writer.h"
+
+// 取り込み処理（デコード → 解析）だけを繰り返し動かした結果
+struct IngestBenchResult {
+    qint64 lines = 0;
+    qint64 parsed = 0;
+    double seconds = 0.0;
+    qint64 allocations = -1;   // malloc の回数（カウンタを読み込んでいなければ -1）
+
+    double linesPerSecond() const { return seconds > 0 ? lines / seconds : 0.0; }
+    double allocationsPerLine() const { return lines > 0 && allocations >= 0 ? double(allocations) / lines : -1.0; }
+};
+
+// 現在の取り込み処理（TextDecoder → LogParser → GambleLogBatch、LogWatcher::check と同じ流れ）
+IngestBenchResult benchIngest(const std::vector<SoakLine>& lines, const QString& encoding,
+                              const QString& chatPrefix, int rounds);
+// 比較用の旧方式（まとめてデコード → split → 正規表現、行ごとに QString を持つ）
+IngestBenchResult benchLegacyIngest(const std::vector<SoakLine>& lines, const QString& encoding,
+                                    const QString& chatPrefix, int rounds);
+
+#endif // INGEST_BENCH_H
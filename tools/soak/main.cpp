@@ -0,0 +1,391 @@
+// GambleLive 負荷試験ツール
+// チャットログを指定レートで書き出しながら、本体と同じ LogWatcher → LogParser → SlotTabController
+// の処理でファイルを追いかけ、書き込みから集計までの遅延・取りこぼし・重複を計測する。
+// ゲームクライアントは不要で、画面も表示しない（offscreen）。
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QListView>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <deque>
+
+#include "amount_sum.h"
+#include "config_manager.h"
+#include "infowidget.h"
+#include "ingest_bench.h"
+#include "log_parser.h"
+#include "log_watcher.h"
+#include "slot_tab_controller.h"
+#include "soak_writer.h"
+#include "text_decoder.h"
+
+namespace {
+
+struct RunOptions {
+    SoakWriterOptions writer;
+    int intervalMs = 10;
+    QString encoding = "Shift-JIS";
+    bool saveLog = false;
+    bool compressLog = false;
+};
+
+struct RunResult {
+    qint64 linesWritten = 0;
+    qint64 expectedEvents = 0;
+    qint64 aggregatedEvents = 0;
+    qint64 lost = 0;
+    qint64 duplicated = 0;
+    qint64 expectedAmount = 0;     // 支払い・受け取りの金額合計（合成ログのみ）
+    qint64 aggregatedAmount = 0;
+    qint64 sessionLogBytes = 0;    // --save 時のセッションログのサイズ
+    int rotations = 0;
+    double writeSeconds = 0.0;
+    std::vector<qint64> latenciesNs;
+
+    double percentileMs(double p) const {
+        if (latenciesNs.empty()) return 0.0;
+        const size_t at = std::min(latenciesNs.size() - 1, static_cast<size_t>(p * latenciesNs.size()));
+        return latenciesNs[at] / 1e6;
+    }
+};
+
+QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+// 1回分の試験。lines を書き出しながら取り込み処理を動かす
+RunResult runOnce(const std::vector<SoakLine>& lines, const RunOptions& options, const QString& workDir)
+{
+    RunResult result;
+
+    const QString logPath = QDir(workDir).filePath("latest.log");
+    QFile::remove(logPath);
+    {
+        QFile create(logPath);
+        create.open(QIODevice::WriteOnly);
+    }
+
+    ConfigManager& config = ConfigManager::instance();
+    config.set("FilePath", logPath);
+    config.set("Encoding", options.encoding);
+    config.set("LogUpdateInterval", options.intervalMs);
+
+    // 種類ごとの期待値と、通し番号 → 行番号の対応
+    qint64 maxSequence = 0;
+    for (const SoakLine& line : lines)
+        maxSequence = std::max(maxSequence, line.sequence);
+    std::vector<qint64> paymentLine(maxSequence + 1, -1), gainLine(maxSequence + 1, -1);
+    std::vector<bool> paymentSeen(maxSequence + 1, false), gainSeen(maxSequence + 1, false);
+    std::deque<size_t> pendingLose, pendingRole, pendingReplay;
+    qint64 expectedPayments = 0, expectedGains = 0, expectedLose = 0, expectedRole = 0, expectedReplay = 0;
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        switch (lines[i].kind) {
+        case SoakLine::Kind::Payment:
+            paymentLine[lines[i].sequence] = i;
+            ++expectedPayments;
+            addAmount(result.expectedAmount, lines[i].sequence);
+            break;
+        case SoakLine::Kind::Gain:
+            gainLine[lines[i].sequence] = i;
+            ++expectedGains;
+            addAmount(result.expectedAmount, lines[i].sequence);
+            break;
+        case SoakLine::Kind::Lose: pendingLose.push_back(i); ++expectedLose; break;
+        case SoakLine::Kind::Role: pendingRole.push_back(i); ++expectedRole; break;
+        case SoakLine::Kind::Replay: pendingReplay.push_back(i); ++expectedReplay; break;
+        case SoakLine::Kind::Noise: break;
+        }
+    }
+    result.linesWritten = static_cast<qint64>(lines.size());
+    result.expectedEvents = expectedPayments + expectedGains + expectedLose + expectedRole + expectedReplay;
+
+    SoakWriterOptions writerOptions = options.writer;
+    writerOptions.path = logPath;
+    SoakWriter writer(writerOptions, lines);
+
+    // 本体と同じ部品を画面に出さずに組み立てる
+    InfoWidget infoWidget;
+    QListView logView;
+    auto* watcher = new LogWatcher();
+    const QString sessionLogPath = QDir(workDir).filePath(
+        options.compressLog ? QString("soak_log") + SessionLogFile::kCompressedSuffix : QString("soak_log.log"));
+    QFile::remove(sessionLogPath);
+    auto* controller = new SlotTabController(watcher, &infoWidget, &logView, options.saveLog, sessionLogPath);
+
+    qint64 payments = 0, gains = 0, loses = 0, roles = 0, replays = 0;
+
+    auto recordLatency = [&](qint64 lineIndex, qint64 nowNs) {
+        if (lineIndex < 0) return;
+        const qint64 writtenNs = writer.writeTimeNs(static_cast<size_t>(lineIndex));
+        if (writtenNs > 0)
+            result.latenciesNs.push_back(nowNs - writtenNs);
+    };
+
+    // controller より後に接続するので、集計が済んだ時点で呼ばれる
+    QObject::connect(watcher, &LogWatcher::newLogBatch, controller, [&](const GambleLogBatch& batch) {
+        const qint64 nowNs = soakNowNs();
+        for (const GambleLog& log : batch.logs) {
+            ++result.aggregatedEvents;
+
+            if (expectedReplay > 0) {
+                ++replays;
+                if (!pendingReplay.empty()) {
+                    recordLatency(static_cast<qint64>(pendingReplay.front()), nowNs);
+                    pendingReplay.pop_front();
+                }
+                continue;
+            }
+
+            switch (log.type) {
+            case GambleLogType::Payment:
+            case GambleLogType::Gain: {
+                const bool payment = log.type == GambleLogType::Payment;
+                auto& seen = payment ? paymentSeen : gainSeen;
+                const auto& lineOf = payment ? paymentLine : gainLine;
+                if (log.amount <= 0 || log.amount > maxSequence || lineOf[log.amount] < 0) {
+                    ++result.duplicated;  // 書いていない番号
+                    break;
+                }
+                if (seen[log.amount]) {
+                    ++result.duplicated;
+                    break;
+                }
+                seen[log.amount] = true;
+                ++(payment ? payments : gains);
+                recordLatency(lineOf[log.amount], nowNs);
+                break;
+            }
+            case GambleLogType::Lose:
+                ++loses;
+                if (!pendingLose.empty()) {
+                    recordLatency(static_cast<qint64>(pendingLose.front()), nowNs);
+                    pendingLose.pop_front();
+                }
+                break;
+            case GambleLogType::Role:
+                ++roles;
+                if (!pendingRole.empty()) {
+                    recordLatency(static_cast<qint64>(pendingRole.front()), nowNs);
+                    pendingRole.pop_front();
+                }
+                break;
+            }
+        }
+    });
+
+    watcher->start();
+
+    // 監視側が空のファイルを開くまで待ってから書き始める
+    QEventLoop loop;
+    QTimer::singleShot(options.intervalMs * 3, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    writer.start();
+
+    qint64 writerDoneNs = 0;
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+        if (!writer.isFinished()) return;
+        if (writerDoneNs == 0) writerDoneNs = soakNowNs();
+
+        // 書き込み完了後、全件届くか猶予（2秒）を過ぎたら終了
+        const bool complete = result.aggregatedEvents >= result.expectedEvents;
+        const bool timedOut = soakNowNs() - writerDoneNs > 2000LL * 1000 * 1000 + options.intervalMs * 1000000LL;
+        if (complete || timedOut)
+            loop.quit();
+    });
+    poll.start(20);
+    loop.exec();
+    writer.join();
+
+    // 索引の金額の列をまとめて合計し、取り込みで金額が変わっていないか確かめる
+    if (expectedReplay == 0) {
+        const EventIndex& index = controller->index();
+        addAmount(result.aggregatedAmount, index.sumAmount(GambleLogType::Payment, 0, index.size()));
+        addAmount(result.aggregatedAmount, index.sumAmount(GambleLogType::Gain, 0, index.size()));
+    }
+
+    delete controller;
+    delete watcher;
+    if (options.saveLog)
+        result.sessionLogBytes = QFileInfo(sessionLogPath).size();
+
+    const qint64 received = payments + gains + loses + roles + replays;
+    result.lost = std::max<qint64>(0, result.expectedEvents - received);
+    if (expectedReplay > 0 || expectedLose + expectedRole > 0) {
+        // 番号を持たない行は件数の差で重複を数える
+        result.duplicated += std::max<qint64>(0, loses - expectedLose) + std::max<qint64>(0, roles - expectedRole)
+                           + std::max<qint64>(0, replays - expectedReplay);
+    }
+    result.rotations = writer.rotations();
+    result.writeSeconds = writer.elapsedNs() / 1e9;
+    std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+    return result;
+}
+
+void printResult(const RunResult& r, double targetRate)
+{
+    out() << QString("  目標レート        : %1 行/秒\n").arg(targetRate, 0, 'f', 0);
+    out() << QString("  書き込み          : %1 行 / %2 秒 (%3 行/秒)\n")
+                 .arg(r.linesWritten)
+                 .arg(r.writeSeconds, 0, 'f', 2)
+                 .arg(r.writeSeconds > 0 ? r.linesWritten / r.writeSeconds : 0.0, 0, 'f', 0);
+    out() << QString("  イベント          : 期待 %1 / 集計 %2\n").arg(r.expectedEvents).arg(r.aggregatedEvents);
+    out() << QString("  取りこぼし / 重複 : %1 / %2\n").arg(r.lost).arg(r.duplicated);
+    out() << QString("  金額合計          : 期待 %1 / 集計 %2\n").arg(r.expectedAmount).arg(r.aggregatedAmount);
+    out() << QString("  ローテーション    : %1 回\n").arg(r.rotations);
+    if (r.sessionLogBytes > 0)
+        out() << QString("  セッションログ    : %1 バイト\n").arg(r.sessionLogBytes);
+    out() << QString("  遅延 (ms)         : p50 %1  p90 %2  p99 %3  max %4\n")
+                 .arg(r.percentileMs(0.50), 0, 'f', 2)
+                 .arg(r.percentileMs(0.90), 0, 'f', 2)
+                 .arg(r.percentileMs(0.99), 0, 'f', 2)
+                 .arg(r.latenciesNs.empty() ? 0.0 : r.latenciesNs.back() / 1e6, 0, 'f', 2);
+    out().flush();
+}
+
+void printBenchResult(const QString& label, const IngestBenchResult& r)
+{
+    const QString allocations = r.allocations >= 0
+        ? QString("%1 回 (%2 回/行)").arg(r.allocations).arg(r.allocationsPerLine(), 0, 'f', 2)
+        : QString("計測不可（LD_PRELOAD に libGambleLiveAllocCount を指定すると数える）");
+    out() << QString("  %1\n").arg(label);
+    out() << QString("    処理速度        : %1 行/秒（%2 行 / %3 秒、解析 %4 件）\n")
+                 .arg(r.linesPerSecond(), 0, 'f', 0)
+                 .arg(r.lines)
+                 .arg(r.seconds, 0, 'f', 3)
+                 .arg(r.parsed);
+    out() << QString("    メモリ確保      : %1\n").arg(allocations);
+    out().flush();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 画面は使わない
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("GambleLive の取り込み処理の負荷試験");
+    parser.addHelpOption();
+    parser.addOption({ "spins", "合成ログの回転数", "n", "20000" });
+    parser.addOption({ "rate", "書き込みレート（行/秒）", "lines", "2000" });
+    parser.addOption({ "burst", "まとめて書く行数", "lines", "1" });
+    parser.addOption({ "rotate-every", "この行数ごとにログを切り詰める（0 で無効）", "lines", "0" });
+    parser.addOption({ "partial", "行を途中で分けて書く割合（0〜1）", "ratio", "0.1" });
+    parser.addOption({ "encoding", "出力エンコーディング（Shift-JIS / UTF-8）", "name", "Shift-JIS" });
+    parser.addOption({ "interval", "LogUpdateInterval（ms）", "ms", "10" });
+    parser.addOption({ "replay", "合成ログの代わりに記録済みログを再生する", "file" });
+    parser.addOption({ "replay-encoding", "記録済みログのエンコーディング", "name", "Shift-JIS" });
+    parser.addOption({ "ramp", "レートを倍にしながら維持できる最大レートを探す" });
+    parser.addOption({ "stage-seconds", "--ramp の1段階あたりの秒数", "s", "5" });
+    parser.addOption({ "max-latency", "--ramp で許容する p99 遅延（ms）", "ms", "250" });
+    parser.addOption({ "save", "セッションログの保存も有効にする" });
+    parser.addOption({ "compress", "--save のセッションログを圧縮形式（.logz）で書く" });
+    parser.addOption({ "bench", "ファイルを介さずデコードと解析だけを繰り返し、旧方式と速度・メモリ確保回数を比べる" });
+    parser.addOption({ "bench-rounds", "--bench の繰り返し回数（最速の回を表示）", "n", "5" });
+    parser.addOption({ "seed", "乱数の種", "n", "1" });
+    parser.process(app);
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        out() << "作業ディレクトリを作成できません\n";
+        return 1;
+    }
+
+    RunOptions options;
+    options.encoding = parser.value("encoding");
+    options.intervalMs = qMax(1, parser.value("interval").toInt());
+    options.saveLog = parser.isSet("save");
+    options.compressLog = parser.isSet("compress");
+    options.writer.linesPerSecond = parser.value("rate").toDouble();
+    options.writer.burstLines = parser.value("burst").toInt();
+    options.writer.rotateEveryLines = parser.value("rotate-every").toLongLong();
+    options.writer.partialWriteRatio = parser.value("partial").toDouble();
+    options.writer.seed = parser.value("seed").toUInt();
+
+    const bool shiftJis = TextDecoder(options.encoding).encoding() == TextDecoder::Encoding::ShiftJis;
+    const QString chatPrefix = ConfigManager::instance().snapshot()->chatPrefix;
+
+    auto makeLines = [&](qint64 spins) {
+        if (!parser.isSet("replay"))
+            return generateSyntheticLines(spins, chatPrefix, shiftJis, options.writer.seed);
+
+        // 記録済みログは本体と同じパーサで事前に判定し、解析される行だけをイベントとして数える
+        std::vector<SoakLine> lines = loadReplayLines(parser.value("replay"), parser.value("replay-encoding"), shiftJis);
+        auto config = ConfigManager::instance().snapshot();
+        RoleTable roles;
+        LogParser logParser(config->chatPrefix, config->parseRules, &roles);
+        TextDecoder decoder(options.encoding);
+        GambleLogBatch batch;
+        QString text;
+        for (SoakLine& line : lines) {
+            text.truncate(0);
+            decoder.reset();
+            decoder.decode(line.bytes.constData(), line.bytes.size(), text);
+            const bool parsed = logParser.parseLine(QStringView(text).trimmed(), batch);
+            line.kind = parsed ? SoakLine::Kind::Replay : SoakLine::Kind::Noise;
+        }
+        return lines;
+    };
+
+    if (parser.isSet("bench")) {
+        const std::vector<SoakLine> lines = makeLines(parser.value("spins").toLongLong());
+        const int rounds = parser.value("bench-rounds").toInt();
+        out() << "GambleLive 取り込み処理ベンチマーク\n";
+        printBenchResult("旧方式（split + 正規表現）", benchLegacyIngest(lines, options.encoding, chatPrefix, rounds));
+        printBenchResult("現在の方式", benchIngest(lines, options.encoding, chatPrefix, rounds));
+        return 0;
+    }
+
+    if (!parser.isSet("ramp")) {
+        const std::vector<SoakLine> lines = makeLines(parser.value("spins").toLongLong());
+        out() << "GambleLive 負荷試験\n";
+        const RunResult result = runOnce(lines, options, workDir.path());
+        printResult(result, options.writer.linesPerSecond);
+        return (result.lost == 0 && result.duplicated == 0
+                && result.aggregatedAmount == result.expectedAmount) ? 0 : 2;
+    }
+
+    // 取りこぼしなし・p99 が許容内の最大レートを探す
+    const double maxLatencyMs = parser.value("max-latency").toDouble();
+    const double stageSeconds = parser.value("stage-seconds").toDouble();
+    double rate = options.writer.linesPerSecond;
+    double sustainable = 0.0;
+
+    out() << "GambleLive 負荷試験（最大レート探索）\n";
+    for (int stage = 0; stage < 16; ++stage, rate *= 2) {
+        options.writer.linesPerSecond = rate;
+        const qint64 spins = qMax<qint64>(1, static_cast<qint64>(rate * stageSeconds / 2.6));  // 1回転 ≈ 2.6 行
+        const RunResult result = runOnce(makeLines(spins), options, workDir.path());
+
+        out() << QString("段階 %1\n").arg(stage + 1);
+        printResult(result, rate);
+
+        const double achieved = result.writeSeconds > 0 ? result.linesWritten / result.writeSeconds : 0.0;
+        const bool ok = result.lost == 0 && result.duplicated == 0
+                     && result.aggregatedAmount == result.expectedAmount
+                     && result.percentileMs(0.99) <= maxLatencyMs
+                     && achieved >= rate * 0.9;
+        if (!ok) break;
+        sustainable = achieved;
+    }
+
+    out() << QString("維持できる最大レート: %1 行/秒\n").arg(sustainable, 0, 'f', 0);
+    out().flush();
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include <QFile>
+#include <QHash>
+#include <QLocale>
+#include <QTime>
+#include <chrono>
+#include <random>
+
+#include "compressed_log.h"
+#include "sjis_table.h"
+#include "soak_writer.h"
+#include "text_decoder.h"
+
+namespace {
+
+// 変換表を逆引きして Shift-JIS のバイト列を作る
+const QHash<char16_t, quint16>& sjisEncodeTable()
+{
+    static const QHash<char16_t, quint16> table = [] {
+        QHash<char16_t, quint16> result;
+        for (int lead = 0x81; lead <= 0xFC; ++lead) {
+            const int row = sjisLeadIndex(static_cast<unsigned char>(lead));
+            if (row < 0) continue;
+            for (int trail = 0x40; trail <= 0xFC; ++trail) {
+                const int col = sjisTrailIndex(static_cast<unsigned char>(trail));
+                if (col < 0) continue;
+                const char16_t ch = kSjisDoubleByteTable[row * kSjisTrailCount + col];
+                if (ch != 0xFFFD && !result.contains(ch))
+                    result.insert(ch, static_cast<quint16>((lead << 8) | trail));
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+QString formatTime(int secondsOfDay)
+{
+    return QTime(0, 0).addSecs(secondsOfDay % (24 * 60 * 60)).toString("[HH:mm:ss]");
+}
+
+} // namespace
+
+qint64 soakNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+QByteArray encodeLine(const QString& text, bool shiftJis)
+{
+    if (!shiftJis)
+        return text.toUtf8() + '\n';
+
+    const auto& table = sjisEncodeTable();
+    QByteArray out;
+    out.reserve(text.size() * 2 + 1);
+    for (QChar c : text) {
+        const char16_t u = c.unicode();
+        if (u < 0x80) {
+            out.append(static_cast<char>(u));
+        } else if (u >= 0xFF61 && u <= 0xFF9F) {
+            out.append(static_cast<char>(0xA1 + (u - 0xFF61)));
+        } else {
+            const quint16 code = table.value(u, 0x8148);  // 変換できない文字は「？」
+            out.append(static_cast<char>(code >> 8));
+            out.append(static_cast<char>(code & 0xFF));
+        }
+    }
+    out.append('\n');
+    return out;
+}
+
+std::vector<SoakLine> generateSyntheticLines(qint64 spins, const QString& chatPrefix, bool shiftJis, quint32 seed)
+{
+    static const QStringList roles = { "チェリー", "ベル", "スイカ", "ビッグボーナス", "レギュラーボーナス" };
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::uniform_int_distribution<int> pickRole(0, roles.size() - 1);
+
+    const QLocale locale(QLocale::English);  // 3桁区切りのカンマ
+    const QString head = " [Render thread/INFO]: " + chatPrefix;
+    int seconds = QTime::currentTime().msecsSinceStartOfDay() / 1000;
+
+    std::vector<SoakLine> lines;
+    lines.reserve(static_cast<size_t>(spins) * 3);
+
+    auto add = [&](SoakLine::Kind kind, qint64 sequence, const QString& body) {
+        SoakLine line;
+        line.kind = kind;
+        line.sequence = sequence;
+        line.bytes = encodeLine(formatTime(seconds) + head + body, shiftJis);
+        lines.push_back(std::move(line));
+    };
+
+    for (qint64 seq = 1; seq <= spins; ++seq) {
+        if (chance(rng) < 0.3)
+            add(SoakLine::Kind::Noise, 0, "<Player" + QString::number(seq % 7) + "> がんばれー");
+
+        add(SoakLine::Kind::Payment, seq, locale.toString(seq) + "円支払いました");
+
+        if (chance(rng) < 0.7) {
+            add(SoakLine::Kind::Lose, seq, "[Man10Slot]外れました");
+        } else {
+            add(SoakLine::Kind::Role, seq, "[Man10Slot]おめでとうございます！" + roles[pickRole(rng)] + "です！");
+            add(SoakLine::Kind::Gain, seq, locale.toString(seq) + "円受け取りました");
+        }
+
+        if (seq % 3 == 0) ++seconds;
+    }
+    return lines;
+}
+
+std::vector<SoakLine> loadReplayLines(const QString& path, const QString& sourceEncoding, bool shiftJis)
+{
+    std::vector<SoakLine> lines;
+
+    // 圧縮して記録したログ（.logz）もそのまま再生できる
+    QByteArray raw;
+    if (!CompressedLog::readAll(path, raw)) return lines;
+
+    TextDecoder decoder(sourceEncoding);
+    QString text;
+    decoder.decode(raw.constData(), raw.size(), text);
+
+    for (QStringView line : QStringView(text).tokenize(QChar(u'\n'), Qt::SkipEmptyParts)) {
+        SoakLine soakLine;
+        soakLine.kind = SoakLine::Kind::Replay;
+        soakLine.bytes = encodeLine(line.trimmed().toString(), shiftJis);
+        lines.push_back(std::move(soakLine));
+    }
+    return lines;
+}
+
+SoakWriter::SoakWriter(const SoakWriterOptions& options, const std::vector<SoakLine>& lines)
+    : options_(options)
+    , lines_(lines)
+    , writeTimes_(new std::atomic<qint64>[lines.size()])
+{
+    for (size_t i = 0; i < lines.size(); ++i)
+        writeTimes_[i].store(0);
+}
+
+SoakWriter::~SoakWriter()
+{
+    join();
+}
+
+void SoakWriter::start()
+{
+    thread_ = std::thread(&SoakWriter::run, this);
+}
+
+void SoakWriter::join()
+{
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void SoakWriter::run()
+{
+    QFile file(options_.path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+        finished_.store(true, std::memory_order_release);
+        return;
+    }
+
+    std::mt19937 rng(options_.seed ^ 0x5eed);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    const int burst = qMax(1, options_.burstLines);
+    const double nsPerLine = 1e9 / qMax(1.0, options_.linesPerSecond);
+    const qint64 startNs = soakNowNs();
+
+    for (size_t i = 0; i < lines_.size(); ++i) {
+        // burst 行ずつまとめて書く。平均レートは linesPerSecond のまま
+        const qint64 dueNs = startNs + static_cast<qint64>((i / burst) * burst * nsPerLine);
+        const qint64 waitNs = dueNs - soakNowNs();
+        if (waitNs > 0)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+
+        if (options_.rotateEveryLines > 0 && i > 0 && static_cast<qint64>(i) % options_.rotateEveryLines == 0) {
+            // ローテーション（ゲーム側の latest.log 作り直しを模す）
+            file.resize(0);
+            file.seek(0);
+            rotations_.fetch_add(1);
+        }
+
+        const QByteArray& bytes = lines_[i].bytes;
+        writeTimes_[i].store(soakNowNs(), std::memory_order_release);
+
+        if (bytes.size() > 2 && chance(rng) < options_.partialWriteRatio) {
+            // 行の途中（マルチバイト文字の途中も含む）で分けて書く
+            const qsizetype split = 1 + static_cast<qsizetype>(chance(rng) * (bytes.size() - 2));
+            file.write(bytes.constData(), split);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            file.write(bytes.constData() + split, bytes.size() - split);
+        } else {
+            file.write(bytes);
+        }
+    }
+
+    elapsedNs_.store(soakNowNs() - startNs);
+    finished_.store(true, std::memory_order_release);
+}
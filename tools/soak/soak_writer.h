@@ -0,0 +1,73 @@
+#ifndef SOAK_WRITER_H
+#define SOAK_WRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// 書き込む1行と、その行が表すイベント
+struct SoakLine {
+    enum class Kind {
+        Noise,      // 解析対象外の行
+        Payment,
+        Gain,
+        Lose,
+        Role,
+        Replay      // 記録ログの行（解析されるかどうかは事前に判定）
+    };
+
+    QByteArray bytes;   // 改行込み、出力エンコーディング済み
+    Kind kind = Kind::Noise;
+    qint64 sequence = 0;  // Payment / Gain の金額に埋め込んだ通し番号
+};
+
+struct SoakWriterOptions {
+    QString path;
+    double linesPerSecond = 500.0;
+    int burstLines = 1;             // この行数ずつまとめて書く（平均レートは同じ）
+    qint64 rotateEveryLines = 0;    // この行数ごとにファイルを切り詰める（0 で無効）
+    double partialWriteRatio = 0.0; // 行を2回に分けて書く割合
+    quint32 seed = 1;
+};
+
+// 合成ログ（Man10Slot のチャット行）を作る
+std::vector<SoakLine> generateSyntheticLines(qint64 spins, const QString& chatPrefix, bool shiftJis, quint32 seed);
+// 記録済みログを読み、行ごとに出力エンコーディングへ変換する
+std::vector<SoakLine> loadReplayLines(const QString& path, const QString& sourceEncoding, bool shiftJis);
+// UTF-16 → 出力エンコーディング
+QByteArray encodeLine(const QString& text, bool shiftJis);
+
+// 別スレッドで指定レートでファイルへ書き込む
+class SoakWriter {
+public:
+    SoakWriter(const SoakWriterOptions& options, const std::vector<SoakLine>& lines);
+    ~SoakWriter();
+
+    void start();
+    void join();
+    bool isFinished() const { return finished_.load(std::memory_order_acquire); }
+
+    // 行を書き始めた時刻（steady_clock の ns）。未書き込みなら 0
+    qint64 writeTimeNs(size_t line) const { return writeTimes_[line].load(std::memory_order_acquire); }
+    int rotations() const { return rotations_.load(); }
+    qint64 elapsedNs() const { return elapsedNs_.load(); }
+
+private:
+    void run();
+
+    SoakWriterOptions options_;
+    const std::vector<SoakLine>& lines_;
+    std::unique_ptr<std::atomic<qint64>[]> writeTimes_;
+    std::thread thread_;
+    std::atomic<bool> finished_{ false };
+    std::atomic<int> rotations_{ 0 };
+    std::atomic<qint64> elapsedNs_{ 0 };
+};
+
+qint64 soakNowNs();
+
+#endif // SOAK_WRITER_H